@@ -1,13 +1,37 @@
 #include "CLIRenderer.h"
-#include <sstream>
+#include "../game/Level.h"
+#include <algorithm>
+#include <csignal>
+
+#ifndef _WIN32
+namespace {
+    // Set from the SIGWINCH handler, consumed on the next render
+    volatile std::sig_atomic_t resizePending = 0;
+    
+    void handleResize(int) {
+        resizePending = 1;
+    }
+}
+#endif
 
 CLIRenderer::CLIRenderer()
+    : terminalCols(80)
+    , terminalRows(24)
+    , fixedSize(false)
+    , halfBlockMode(false)
+    , cameraLeft(0)
+    , cameraTop(0)
+    , viewCols(0)
+    , viewRows(0)
+    , renderedTick(0)
+    , repaintPending(true)
 #ifndef _WIN32
-    : terminalModified(false)
+    , terminalModified(false)
 #endif
 {
     setupTerminal();
     hideCursor();
+    updateViewport();
 }
 
 CLIRenderer::~CLIRenderer() {
@@ -16,55 +40,266 @@ CLIRenderer::~CLIRenderer() {
 }
 
 void CLIRenderer::render(const SnakeGame& game) {
-    moveCursor(0, 0);
+#ifdef _WIN32
+    // No SIGWINCH on Windows - querying the console buffer is cheap enough
+    int previousCols = terminalCols;
+    int previousRows = terminalRows;
+    updateViewport();
+    if (terminalCols != previousCols || terminalRows != previousRows) {
+        repaintPending = true;
+        clear();
+    }
+#else
+    if (resizePending) {
+        resizePending = 0;
+        updateViewport();
+        repaintPending = true;
+        clear();
+    }
+#endif
     
-    const auto& snake = game.getSnakeBody();
-    const auto& food = game.getFoodPosition();
     int width = game.getBoardWidth();
     int height = game.getBoardHeight();
     
+    // Two columns for the side borders, four lines for the borders and status
+    int cols = std::max(1, std::min(width, terminalCols - 2));
+    int lines = std::max(1, terminalRows - 4);
+    int rows = std::min(height, halfBlockMode ? lines * 2 : lines);
+    
+    const Position& head = game.getSnakeBody().front();
+    int left = followCamera(head.x, cameraLeft, width, cols);
+    int top = followCamera(head.y, cameraTop, height, rows);
+    
+    // Anything but the very next tick on an unchanged viewport needs a full frame
+    const CellChangeList& changes = game.getCellChanges();
+    std::uint32_t tick = game.getTick();
+    bool fullRepaint = repaintPending || changes.fullRepaint ||
+                       left != cameraLeft || top != cameraTop ||
+                       cols != viewCols || rows != viewRows ||
+                       (tick != renderedTick && tick != renderedTick + 1);
+    
+    cameraLeft = left;
+    cameraTop = top;
+    viewCols = cols;
+    viewRows = rows;
+    
+    if (fullRepaint) {
+        repaintPending = false;
+        drawFullFrame(game);
+    } else if (tick != renderedTick) {
+        applyCellChanges(game, changes);
+    }
+    renderedTick = tick;
+    
+    // Score, then the status on what may be the terminal's last line. It gets
+    // no newline and is cut short of the last column so the screen never scrolls.
+    int textRows = halfBlockMode ? (rows + 1) / 2 : rows;
+    moveCursor(0, textRows + 2);
+    std::cout << "Score: " << game.getScore() << "\033[K\n";
+    std::string status = statusText.empty() ? "Controls: WASD or Arrow Keys | H half-block | Q to quit" : statusText;
+    status.resize(std::min(status.size(), static_cast<size_t>(std::max(0, terminalCols - 1))));
+    std::cout << status << "\033[K" << std::flush;
+}
+
+void CLIRenderer::setHalfBlockMode(bool enabled) {
+    if (halfBlockMode != enabled) {
+        halfBlockMode = enabled;
+        repaintPending = true;
+        clear();
+    }
+}
+
+void CLIRenderer::setTerminalSize(int cols, int rows) {
+    fixedSize = true;
+    terminalCols = cols;
+    terminalRows = rows;
+    repaintPending = true;
+}
+
+void CLIRenderer::updateViewport() {
+    if (fixedSize) {
+        return;
+    }
+    
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        terminalCols = info.srWindow.Right - info.srWindow.Left + 1;
+        terminalRows = info.srWindow.Bottom - info.srWindow.Top + 1;
+    }
+#else
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0) {
+        terminalCols = size.ws_col;
+        terminalRows = size.ws_row;
+    }
+#endif
+}
+
+int CLIRenderer::followCamera(int focus, int origin, int boardSize, int viewSize) {
+    if (viewSize >= boardSize) {
+        return 0;
+    }
+    
+    // Only scroll once the focus gets near the edge, so most frames keep the
+    // camera still and can be drawn incrementally
+    int margin = viewSize / 4;
+    if (focus < origin + margin || focus >= origin + viewSize - margin) {
+        origin = focus - viewSize / 2;
+    }
+    return std::max(0, std::min(origin, boardSize - viewSize));
+}
+
+void CLIRenderer::drawFullFrame(const SnakeGame& game) {
+    rasterize(game);
+    
+    moveCursor(0, 0);
+    
     std::ostringstream output;
     
     // Top border
     output << "+";
-    for (int i = 0; i < width; ++i) output << "-";
+    for (int i = 0; i < viewCols; ++i) output << "-";
     output << "+\n";
     
     // Game area
-    for (int y = 0; y < height; ++y) {
-        output << "|";
-        for (int x = 0; x < width; ++x) {
-            Position pos(x, y);
-            
-            if (pos == food) {
-                output << "*";
-            } else {
-                bool isSnake = false;
-                for (const auto& segment : snake) {
-                    if (segment == pos) {
-                        output << "#";
-                        isSnake = true;
-                        break;
-                    }
-                }
-                if (!isSnake) {
-                    output << " ";
-                }
+    if (halfBlockMode) {
+        for (int y = 0; y < viewRows; y += 2) {
+            output << "|";
+            for (int x = 0; x < viewCols; ++x) {
+                writeHalfBlockGlyph(output, x, y);
+            }
+            output << "|\n";
+        }
+    } else {
+        for (int y = 0; y < viewRows; ++y) {
+            output << "|";
+            for (int x = 0; x < viewCols; ++x) {
+                writeFullBlockGlyph(output, viewCells[y * viewCols + x]);
             }
+            output << "|\n";
         }
-        output << "|\n";
     }
     
     // Bottom border
     output << "+";
-    for (int i = 0; i < width; ++i) output << "-";
+    for (int i = 0; i < viewCols; ++i) output << "-";
     output << "+\n";
     
-    // Score
-    output << "Score: " << game.getScore() << "\n";
-    output << "Controls: WASD or Arrow Keys | Q to quit\n";
+    std::cout << output.str();
+}
+
+void CLIRenderer::applyCellChanges(const SnakeGame& game, const CellChangeList& changes) {
+    const Level* level = game.getLevel();
     
-    std::cout << output.str() << std::flush;
+    // Update the model first so half-block glyphs see both of their rows
+    for (int i = 0; i < changes.count; ++i) {
+        const CellChange& change = changes.changes[i];
+        int x = change.position.x - cameraLeft;
+        int y = change.position.y - cameraTop;
+        if (x < 0 || x >= viewCols || y < 0 || y >= viewRows) {
+            continue;
+        }
+        
+        Cell cell = Cell::EMPTY;
+        if (change.after == CellContent::SNAKE) {
+            cell = Cell::SNAKE;
+        } else if (change.after == CellContent::FOOD) {
+            cell = Cell::FOOD;
+        } else if (level && level->isPortal(change.position)) {
+            cell = Cell::PORTAL;
+        }
+        viewCells[y * viewCols + x] = cell;
+    }
+    
+    std::ostringstream output;
+    for (int i = 0; i < changes.count; ++i) {
+        const CellChange& change = changes.changes[i];
+        int x = change.position.x - cameraLeft;
+        int y = change.position.y - cameraTop;
+        if (x < 0 || x >= viewCols || y < 0 || y >= viewRows) {
+            continue;
+        }
+        
+        // Skip the border column and row
+        if (halfBlockMode) {
+            output << "\033[" << (y / 2 + 2) << ";" << (x + 2) << "H";
+            writeHalfBlockGlyph(output, x, y - y % 2);
+        } else {
+            output << "\033[" << (y + 2) << ";" << (x + 2) << "H";
+            writeFullBlockGlyph(output, viewCells[y * viewCols + x]);
+        }
+    }
+    std::cout << output.str();
+}
+
+void CLIRenderer::rasterize(const SnakeGame& game) {
+    int cols = viewCols;
+    int rows = viewRows;
+    int left = cameraLeft;
+    int top = cameraTop;
+    
+    viewCells.assign(static_cast<size_t>(cols) * rows, Cell::EMPTY);
+    
+    // Snake cells come from the occupancy world, so a repaint costs the size of
+    // the viewport no matter how long the snake has grown
+    const Level* level = game.getLevel();
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < cols; ++x) {
+            Position pos(left + x, top + y);
+            if (game.isSnakeAt(pos)) {
+                viewCells[y * cols + x] = Cell::SNAKE;
+            } else if (level && level->isWall(pos)) {
+                viewCells[y * cols + x] = Cell::WALL;
+            } else if (level && level->isPortal(pos)) {
+                viewCells[y * cols + x] = Cell::PORTAL;
+            }
+        }
+    }
+    
+    const auto& food = game.getFoodPosition();
+    int x = food.x - left;
+    int y = food.y - top;
+    if (x >= 0 && x < cols && y >= 0 && y < rows) {
+        viewCells[y * cols + x] = Cell::FOOD;
+    }
+}
+
+void CLIRenderer::writeFullBlockGlyph(std::ostringstream& output, Cell cell) {
+    switch (cell) {
+        case Cell::SNAKE:  output << "#"; break;
+        case Cell::FOOD:   output << "*"; break;
+        case Cell::WALL:   output << "%"; break;
+        case Cell::PORTAL: output << "@"; break;
+        default:           output << " "; break;
+    }
+}
+
+void CLIRenderer::writeHalfBlockGlyph(std::ostringstream& output, int x, int y) const {
+    // ANSI foreground colors, background is the foreground code + 10
+    auto colorOf = [](Cell cell) {
+        switch (cell) {
+            case Cell::SNAKE:  return 32;
+            case Cell::FOOD:   return 31;
+            case Cell::PORTAL: return 35;
+            default:           return 37;
+        }
+    };
+    
+    Cell upper = viewCells[y * viewCols + x];
+    Cell lower = (y + 1 < viewRows) ? viewCells[(y + 1) * viewCols + x] : Cell::EMPTY;
+    
+    if (upper == Cell::EMPTY && lower == Cell::EMPTY) {
+        output << " ";
+    } else if (upper == lower) {
+        output << "\033[" << colorOf(upper) << "m\xE2\x96\x88\033[0m";
+    } else if (lower == Cell::EMPTY) {
+        output << "\033[" << colorOf(upper) << "m\xE2\x96\x80\033[0m";
+    } else if (upper == Cell::EMPTY) {
+        output << "\033[" << colorOf(lower) << "m\xE2\x96\x84\033[0m";
+    } else {
+        output << "\033[" << colorOf(upper) << ";" << colorOf(lower) + 10 << "m\xE2\x96\x80\033[0m";
+    }
 }
 
 void CLIRenderer::clear() {
@@ -86,6 +321,8 @@ bool CLIRenderer::hasInput() {
 #ifdef _WIN32
     return _kbhit();
 #else
+    // EOF is sticky on stdin, so clear it after each empty non-blocking read
+    clearerr(stdin);
     int ch = getchar();
     if (ch != EOF) {
         ungetc(ch, stdin);
@@ -115,15 +352,9 @@ Direction CLIRenderer::getDirectionFromInput(char input) {
             return Direction::RIGHT;
         case 27: // Escape sequence for arrow keys on Unix
             {
-                char seq1 = getInput(); // consume '['
-                if (seq1 == '[') {
-                    char seq2 = getInput();
-                    switch (seq2) {
-                        case 'A': return Direction::UP;
-                        case 'B': return Direction::DOWN;
-                        case 'C': return Direction::RIGHT;
-                        case 'D': return Direction::LEFT;
-                    }
+                Direction direction;
+                if (readArrowSequence(direction)) {
+                    return direction;
                 }
             }
             break;
@@ -141,6 +372,46 @@ Direction CLIRenderer::getDirectionFromInput(char input) {
     return Direction::UP; // Default fallback, won't be used if input is invalid
 }
 
+bool CLIRenderer::readArrowSequence(Direction& direction) {
+    if (getInput() != '[') {
+        return false;
+    }
+    
+    // Parameters such as the "5" in Page Up's ESC [ 5 ~ come before the final byte
+    char code = getInput();
+    while ((code >= '0' && code <= '9') || code == ';') {
+        code = getInput();
+    }
+    
+    switch (code) {
+        case 'A': direction = Direction::UP;    return true;
+        case 'B': direction = Direction::DOWN;  return true;
+        case 'C': direction = Direction::RIGHT; return true;
+        case 'D': direction = Direction::LEFT;  return true;
+    }
+    return false;
+}
+
+bool CLIRenderer::readExtendedKey(char input, bool& arrow, Direction& direction) {
+    arrow = false;
+#ifdef _WIN32
+    if (input != 0 && static_cast<unsigned char>(input) != 224) {
+        return false;
+    }
+    
+    char code = getInput();
+    if (code == 72 || code == 75 || code == 77 || code == 80) {
+        arrow = true;
+        direction = getDirectionFromInput(code);
+    }
+    return true;
+#else
+    (void)input;
+    (void)direction;
+    return false;
+#endif
+}
+
 void CLIRenderer::setupTerminal() {
 #ifdef _WIN32
     // Windows console setup
@@ -149,6 +420,15 @@ void CLIRenderer::setupTerminal() {
     GetConsoleCursorInfo(hConsole, &cursorInfo);
     cursorInfo.bVisible = FALSE;
     SetConsoleCursorInfo(hConsole, &cursorInfo);
+    
+    // Half-block mode emits UTF-8 and ANSI colors
+    SetConsoleOutputCP(CP_UTF8);
+#ifdef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+    DWORD mode = 0;
+    if (GetConsoleMode(hConsole, &mode)) {
+        SetConsoleMode(hConsole, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
 #else
     // Unix/Linux terminal setup
     tcgetattr(STDIN_FILENO, &originalTermios);
@@ -163,6 +443,13 @@ void CLIRenderer::setupTerminal() {
     // Make stdin non-blocking
     int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
     fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK);
+    
+    // Track terminal resizes so the viewport follows the window size
+    struct sigaction winch;
+    winch.sa_handler = handleResize;
+    sigemptyset(&winch.sa_mask);
+    winch.sa_flags = SA_RESTART;
+    sigaction(SIGWINCH, &winch, &originalWinch);
 #endif
 }
 
@@ -172,6 +459,7 @@ void CLIRenderer::restoreTerminal() {
         tcsetattr(STDIN_FILENO, TCSANOW, &originalTermios);
         int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
         fcntl(STDIN_FILENO, F_SETFL, flags & ~O_NONBLOCK);
+        sigaction(SIGWINCH, &originalWinch, nullptr);
         terminalModified = false;
     }
 #endif
@@ -2,6 +2,8 @@
 
 #include "../game/SnakeGame.h"
 #include <iostream>
+#include <vector>
+#include <sstream>
 
 #ifdef _WIN32
     #include <conio.h>
@@ -10,6 +12,8 @@
     #include <termios.h>
     #include <unistd.h>
     #include <fcntl.h>
+    #include <signal.h>
+    #include <sys/ioctl.h>
 #endif
 
 class CLIRenderer : public Renderer {
@@ -26,15 +30,66 @@ public:
     char getInput();
     Direction getDirectionFromInput(char input);
     
+    // Reads the rest of an escape sequence after ESC. Returns true and sets
+    // direction for the arrow keys, false for any other sequence.
+    bool readArrowSequence(Direction& direction);
+    
+    // Windows sends special keys as a 0/224 prefix and a scan code that
+    // collides with letters (72 is 'H'). Returns true and consumes the scan
+    // code when input is such a prefix; arrow is set for the arrow keys.
+    bool readExtendedKey(char input, bool& arrow, Direction& direction);
+    
+    // Half-block mode packs two board rows into one terminal line
+    void setHalfBlockMode(bool enabled);
+    bool isHalfBlockMode() const { return halfBlockMode; }
+    
+    // Replaces the controls line, empty restores the default
+    void setStatusText(const std::string& text) { statusText = text; }
+    
+    // Redraw everything on the next render, e.g. after the game jumped in time
+    void requestRepaint() { repaintPending = true; }
+    
+    // Use a fixed size instead of querying the terminal, e.g. when output is captured
+    void setTerminalSize(int cols, int rows);
+    
 private:
+    enum class Cell : unsigned char {
+        EMPTY, SNAKE, FOOD, WALL, PORTAL
+    };
+    
     void setupTerminal();
     void restoreTerminal();
     void hideCursor();
     void showCursor();
     void moveCursor(int x, int y);
     
+    // Viewport handling - only the cells around the snake's head are drawn
+    void updateViewport();
+    static int followCamera(int focus, int origin, int boardSize, int viewSize);
+    void drawFullFrame(const SnakeGame& game);
+    void applyCellChanges(const SnakeGame& game, const CellChangeList& changes);
+    void rasterize(const SnakeGame& game);
+    static void writeFullBlockGlyph(std::ostringstream& output, Cell cell);
+    void writeHalfBlockGlyph(std::ostringstream& output, int x, int y) const;
+    
+    std::vector<Cell> viewCells;
+    int terminalCols;
+    int terminalRows;
+    bool fixedSize;
+    bool halfBlockMode;
+    
+    // What is currently on screen, used to apply per-tick cell changes
+    int cameraLeft;
+    int cameraTop;
+    int viewCols;
+    int viewRows;
+    std::uint32_t renderedTick;
+    bool repaintPending;
+    std::string statusText;
+    
 #ifndef _WIN32
     struct termios originalTermios;
+    struct sigaction originalWinch;
     bool terminalModified;
 #endif
 };
\ No newline at end of file
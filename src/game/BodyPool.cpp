@@ -0,0 +1,89 @@
+#include "BodyPool.h"
+#include <new>
+
+namespace {
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+    
+    // Set once the thread's cache is gone, e.g. for a body freed by a static
+    // SnakeGame at exit. Trivially destructible, so it stays readable to the end.
+    thread_local bool cacheDestroyed = false;
+    
+    struct ThreadCache {
+        FreeBlock* heads[BodyPool::SIZE_CLASSES] = {};
+        int counts[BodyPool::SIZE_CLASSES] = {};
+        BodyPool::Stats stats;
+        
+        ~ThreadCache() {
+            cacheDestroyed = true;
+            for (FreeBlock* head : heads) {
+                while (head) {
+                    FreeBlock* next = head->next;
+                    ::operator delete(head);
+                    head = next;
+                }
+            }
+        }
+    };
+    
+    thread_local ThreadCache cache;
+    
+    // Stops at the largest class, so MIN_BLOCK_BYTES << index never overflows
+    int sizeClass(size_t bytes) {
+        int index = 0;
+        size_t size = BodyPool::MIN_BLOCK_BYTES;
+        while (size < bytes) {
+            if (index == BodyPool::SIZE_CLASSES - 1) {
+                throw std::bad_alloc();
+            }
+            size <<= 1;
+            index++;
+        }
+        return index;
+    }
+}
+
+size_t BodyPool::blockSize(size_t bytes) {
+    return MIN_BLOCK_BYTES << sizeClass(bytes);
+}
+
+void* BodyPool::allocate(size_t bytes) {
+    int index = sizeClass(bytes);
+    if (cacheDestroyed) {
+        return ::operator new(MIN_BLOCK_BYTES << index);
+    }
+    
+    if (FreeBlock* block = cache.heads[index]) {
+        cache.heads[index] = block->next;
+        cache.counts[index]--;
+        cache.stats.reuses++;
+        cache.stats.cachedBytes -= MIN_BLOCK_BYTES << index;
+        return block;
+    }
+    
+    cache.stats.heapAllocations++;
+    return ::operator new(MIN_BLOCK_BYTES << index);
+}
+
+void BodyPool::deallocate(void* block, size_t bytes) {
+    if (!block) {
+        return;
+    }
+    
+    int index = sizeClass(bytes);
+    if (cacheDestroyed || cache.counts[index] >= MAX_CACHED_PER_CLASS) {
+        ::operator delete(block);
+        return;
+    }
+    
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = cache.heads[index];
+    cache.heads[index] = freed;
+    cache.counts[index]++;
+    cache.stats.cachedBytes += MIN_BLOCK_BYTES << index;
+}
+
+BodyPool::Stats BodyPool::getThreadStats() {
+    return cacheDestroyed ? Stats() : cache.stats;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+
+// Per-thread free lists of snake body buffers, bucketed by power-of-two size.
+// Buffers released by a finished or reset game are handed to the next game on
+// the same thread instead of going back to the heap. Every buffer is its own
+// heap block, so it may be released on a different thread than it came from.
+class BodyPool {
+public:
+    static constexpr int MIN_BLOCK_SHIFT = 8;
+    static constexpr size_t MIN_BLOCK_BYTES = size_t(1) << MIN_BLOCK_SHIFT;
+    // One class per power of two up to the largest size_t can hold
+    static constexpr int SIZE_CLASSES = static_cast<int>(sizeof(size_t) * CHAR_BIT) - MIN_BLOCK_SHIFT;
+    static constexpr int MAX_CACHED_PER_CLASS = 64;
+    
+    struct Stats {
+        size_t heapAllocations = 0;
+        size_t reuses = 0;
+        size_t cachedBytes = 0;
+    };
+    
+    static void* allocate(size_t bytes);
+    static void deallocate(void* block, size_t bytes);
+    
+    // Counters for the calling thread only
+    static Stats getThreadStats();
+    
+    // Size actually reserved for a request, callers can size buffers to fit.
+    // Throws std::bad_alloc, like allocate(), when no size class is that big.
+    static size_t blockSize(size_t bytes);
+};
+
+// Stateless allocator that routes std::vector storage through BodyPool
+template <typename T>
+struct BodyAllocator {
+    using value_type = T;
+    
+    BodyAllocator() = default;
+    template <typename U>
+    BodyAllocator(const BodyAllocator<U>&) {}
+    
+    T* allocate(size_t count) {
+        return static_cast<T*>(BodyPool::allocate(count * sizeof(T)));
+    }
+    
+    void deallocate(T* block, size_t count) {
+        BodyPool::deallocate(block, count * sizeof(T));
+    }
+    
+    template <typename U>
+    bool operator==(const BodyAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const BodyAllocator<U>&) const { return false; }
+};
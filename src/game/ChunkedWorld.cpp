@@ -0,0 +1,80 @@
+#include "ChunkedWorld.h"
+#include "SnakeGame.h"
+#include <cstdlib>
+
+void ChunkedWorld::clear() {
+    // Keep the chunks allocated so a reset does not churn the allocator,
+    // evictDistant() drops the ones that are no longer near the snake
+    for (auto& entry : chunks) {
+        entry.second.cells.reset();
+        entry.second.population = 0;
+    }
+}
+
+void ChunkedWorld::preallocate(int width, int height) {
+    int chunksX = chunkCoord(width - 1) + 1;
+    int chunksY = chunkCoord(height - 1) + 1;
+    chunks.reserve(static_cast<size_t>(chunksX) * chunksY);
+    for (int y = 0; y < chunksY; ++y) {
+        for (int x = 0; x < chunksX; ++x) {
+            chunks[keyOf(x, y)];
+        }
+    }
+}
+
+bool ChunkedWorld::isOccupied(const Position& pos) const {
+    auto it = chunks.find(keyOf(chunkCoord(pos.x), chunkCoord(pos.y)));
+    return it != chunks.end() && it->second.cells.test(indexOf(pos));
+}
+
+void ChunkedWorld::occupy(const Position& pos) {
+    Chunk& chunk = chunks[keyOf(chunkCoord(pos.x), chunkCoord(pos.y))];
+    size_t index = indexOf(pos);
+    if (!chunk.cells.test(index)) {
+        chunk.cells.set(index);
+        chunk.population++;
+    }
+}
+
+void ChunkedWorld::release(const Position& pos) {
+    auto it = chunks.find(keyOf(chunkCoord(pos.x), chunkCoord(pos.y)));
+    if (it == chunks.end()) {
+        return;
+    }
+    
+    size_t index = indexOf(pos);
+    if (it->second.cells.test(index)) {
+        it->second.cells.reset(index);
+        it->second.population--;
+    }
+}
+
+void ChunkedWorld::evictDistant(const Position& focus) {
+    int focusX = chunkCoord(focus.x);
+    int focusY = chunkCoord(focus.y);
+    
+    for (auto it = chunks.begin(); it != chunks.end(); ) {
+        int chunkX = static_cast<std::int32_t>(it->first >> 32);
+        int chunkY = static_cast<std::int32_t>(it->first & 0xFFFFFFFFu);
+        bool distant = std::abs(chunkX - focusX) > EVICT_DISTANCE ||
+                       std::abs(chunkY - focusY) > EVICT_DISTANCE;
+        
+        if (distant && it->second.population == 0) {
+            it = chunks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::uint64_t ChunkedWorld::keyOf(int chunkX, int chunkY) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkX)) << 32) |
+           static_cast<std::uint32_t>(chunkY);
+}
+
+size_t ChunkedWorld::indexOf(const Position& pos) {
+    // Masking keeps negative coordinates inside their chunk as well
+    int localX = pos.x & (CHUNK_SIZE - 1);
+    int localY = pos.y & (CHUNK_SIZE - 1);
+    return static_cast<size_t>(localY * CHUNK_SIZE + localX);
+}
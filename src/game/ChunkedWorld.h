@@ -0,0 +1,42 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <unordered_map>
+
+struct Position;
+
+// Sparse occupancy grid made of fixed-size chunks that are created on demand.
+// Memory grows with the number of occupied chunks, not with the board size.
+class ChunkedWorld {
+public:
+    static constexpr int CHUNK_SHIFT = 5;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT; // 32x32 cells per chunk
+    static constexpr int EVICT_DISTANCE = 2;            // in chunks from the focus
+    
+    void clear();
+    
+    // Create every chunk of a bounded board up front so play never allocates
+    void preallocate(int width, int height);
+    
+    bool isOccupied(const Position& pos) const;
+    void occupy(const Position& pos);
+    void release(const Position& pos);
+    
+    // Drop empty chunks that are more than EVICT_DISTANCE chunks from focus
+    void evictDistant(const Position& focus);
+    
+    size_t getChunkCount() const { return chunks.size(); }
+    static int chunkCoord(int cell) { return cell >> CHUNK_SHIFT; }
+    
+private:
+    struct Chunk {
+        std::bitset<CHUNK_SIZE * CHUNK_SIZE> cells;
+        int population = 0;
+    };
+    
+    static std::uint64_t keyOf(int chunkX, int chunkY);
+    static size_t indexOf(const Position& pos);
+    
+    std::unordered_map<std::uint64_t, Chunk> chunks;
+};
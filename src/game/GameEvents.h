@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SpscQueue.h"
+
+// Typed notifications published by SnakeGame::update() and reset(). Only the
+// fields listed for each type are meaningful.
+struct GameEvent {
+    enum class Type : std::uint8_t {
+        RESET,          // score
+        MOVED,          // head, tail (when tailRemoved)
+        ATE_FOOD,       // head
+        FOOD_SPAWNED,   // food
+        SCORE_CHANGED,  // score
+        DIED            // head, score
+    };
+    
+    Type type;
+    bool tailRemoved;
+    std::uint32_t tick;
+    int headX, headY;
+    int tailX, tailY;
+    int foodX, foodY;
+    int score;
+};
+
+using GameEventQueue = SpscQueue<GameEvent, 1024>;
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// 32-bit Mersenne Twister that produces the same sequence as std::mt19937 but
+// exposes its state, so snapshots and replays can store it as raw words.
+class GameRng {
+public:
+    using result_type = std::uint32_t;
+    static constexpr size_t STATE_WORDS = 624;
+    
+    explicit GameRng(result_type value = 5489u) { seed(value); }
+    
+    void seed(result_type value) {
+        state[0] = value;
+        for (size_t i = 1; i < STATE_WORDS; ++i) {
+            state[i] = 1812433253u * (state[i - 1] ^ (state[i - 1] >> 30)) + static_cast<std::uint32_t>(i);
+        }
+        index = STATE_WORDS;
+    }
+    
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+    
+    result_type operator()() {
+        if (index >= STATE_WORDS) {
+            twist();
+        }
+        std::uint32_t y = state[index++];
+        y ^= y >> 11;
+        y ^= (y << 7) & 0x9D2C5680u;
+        y ^= (y << 15) & 0xEFC60000u;
+        y ^= y >> 18;
+        return y;
+    }
+    
+    const std::array<std::uint32_t, STATE_WORDS>& getState() const { return state; }
+    std::uint32_t getIndex() const { return index; }
+    
+    bool setState(const std::array<std::uint32_t, STATE_WORDS>& words, std::uint32_t position) {
+        if (position > STATE_WORDS) {
+            return false;
+        }
+        state = words;
+        index = position;
+        return true;
+    }
+    
+private:
+    static constexpr size_t SHIFT = 397;
+    
+    void twist() {
+        for (size_t i = 0; i < STATE_WORDS; ++i) {
+            std::uint32_t y = (state[i] & 0x80000000u) | (state[(i + 1) % STATE_WORDS] & 0x7FFFFFFFu);
+            state[i] = state[(i + SHIFT) % STATE_WORDS] ^ (y >> 1) ^ ((y & 1u) ? 0x9908B0DFu : 0u);
+        }
+        index = 0;
+    }
+    
+    std::array<std::uint32_t, STATE_WORDS> state;
+    std::uint32_t index;
+};
@@ -0,0 +1,182 @@
+#include "Level.h"
+#include "SnakeGame.h"
+#include <cstring>
+#include <iostream>
+
+Level::Level()
+    : header(nullptr)
+    , wallMask(nullptr)
+    , portals(nullptr)
+    , portalCount(0)
+    , wallDistance(nullptr)
+    , spawnDistance(nullptr)
+{
+}
+
+Level::~Level() {
+    unload();
+}
+
+bool Level::load(const std::string& path) {
+    unload();
+    
+    if (!file.open(path)) {
+        std::cerr << "Could not map level file: " << path << "\n";
+        unload();
+        return false;
+    }
+    
+    if (!bindSections()) {
+        std::cerr << "Invalid level file: " << path << "\n";
+        unload();
+        return false;
+    }
+    
+    return true;
+}
+
+void Level::unload() {
+    file.close();
+    header = nullptr;
+    wallMask = nullptr;
+    portals = nullptr;
+    portalCount = 0;
+    wallDistance = nullptr;
+    spawnDistance = nullptr;
+}
+
+Position Level::getSpawn() const {
+    return Position(header->spawnX, header->spawnY);
+}
+
+bool Level::isWall(const Position& pos) const {
+    if (pos.x < 0 || pos.x >= getWidth() || pos.y < 0 || pos.y >= getHeight()) {
+        return true;
+    }
+    size_t index = cellIndex(pos);
+    return (wallMask[index >> 3] >> (index & 7)) & 1;
+}
+
+bool Level::isPortal(const Position& pos) const {
+    Position exit;
+    return findPortalExit(pos, exit);
+}
+
+bool Level::findPortalExit(const Position& entry, Position& exit) const {
+    // Levels hold at most a few dozen portals, a linear scan beats any index
+    for (size_t i = 0; i < portalCount; ++i) {
+        if (portals[i].fromX == entry.x && portals[i].fromY == entry.y) {
+            exit = Position(portals[i].toX, portals[i].toY);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::uint16_t Level::getWallDistance(const Position& pos) const {
+    if (!wallDistance || isWall(pos)) {
+        return LevelFormat::UNREACHABLE;
+    }
+    return wallDistance[cellIndex(pos)];
+}
+
+std::uint16_t Level::getSpawnDistance(const Position& pos) const {
+    if (!spawnDistance || isWall(pos)) {
+        return LevelFormat::UNREACHABLE;
+    }
+    return spawnDistance[cellIndex(pos)];
+}
+
+bool Level::bindSections() {
+    using namespace LevelFormat;
+    
+    const unsigned char* data = file.data();
+    size_t size = file.size();
+    if (size < sizeof(LevelHeader)) {
+        return false;
+    }
+    
+    const auto* candidate = reinterpret_cast<const LevelHeader*>(data);
+    if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        candidate->version != VERSION ||
+        candidate->width == 0 || candidate->width > MAX_DIMENSION ||
+        candidate->height == 0 || candidate->height > MAX_DIMENSION) {
+        return false;
+    }
+    
+    size_t tableEnd = sizeof(LevelHeader) + static_cast<size_t>(candidate->sectionCount) * sizeof(LevelSection);
+    if (tableEnd > size) {
+        return false;
+    }
+    
+    size_t cells = static_cast<size_t>(candidate->width) * candidate->height;
+    const auto* sections = reinterpret_cast<const LevelSection*>(data + sizeof(LevelHeader));
+    
+    for (std::uint32_t i = 0; i < candidate->sectionCount; ++i) {
+        const LevelSection& section = sections[i];
+        if (section.offset % 4 != 0 || section.offset > size || section.size > size - section.offset) {
+            return false;
+        }
+        
+        const unsigned char* payload = data + section.offset;
+        switch (section.type) {
+            case WALL_MASK:
+                if (section.size < (cells + 7) / 8) return false;
+                wallMask = payload;
+                break;
+            case PORTALS:
+                if (section.size % sizeof(LevelPortal) != 0) return false;
+                portals = reinterpret_cast<const LevelPortal*>(payload);
+                portalCount = section.size / sizeof(LevelPortal);
+                break;
+            case WALL_DISTANCE:
+                if (section.size < cells * sizeof(std::uint16_t)) return false;
+                wallDistance = reinterpret_cast<const std::uint16_t*>(payload);
+                break;
+            case SPAWN_DISTANCE:
+                if (section.size < cells * sizeof(std::uint16_t)) return false;
+                spawnDistance = reinterpret_cast<const std::uint16_t*>(payload);
+                break;
+            default:
+                // Unknown sections are skipped so newer compilers stay loadable
+                break;
+        }
+    }
+    
+    if (!wallMask) {
+        return false;
+    }
+    
+    auto inside = [candidate](std::int32_t x, std::int32_t y) {
+        return x >= 0 && y >= 0 &&
+               static_cast<std::uint32_t>(x) < candidate->width &&
+               static_cast<std::uint32_t>(y) < candidate->height;
+    };
+    
+    auto walkable = [&](std::int32_t x, std::int32_t y) {
+        if (!inside(x, y)) {
+            return false;
+        }
+        size_t index = static_cast<size_t>(y) * candidate->width + static_cast<size_t>(x);
+        return ((wallMask[index >> 3] >> (index & 7)) & 1) == 0;
+    };
+    
+    // The starting body extends two cells to the left of the spawn
+    for (std::int32_t i = 0; i < 3; ++i) {
+        if (!walkable(candidate->spawnX - i, candidate->spawnY)) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < portalCount; ++i) {
+        if (!inside(portals[i].fromX, portals[i].fromY) || !inside(portals[i].toX, portals[i].toY)) {
+            return false;
+        }
+    }
+    
+    header = candidate;
+    return true;
+}
+
+size_t Level::cellIndex(const Position& pos) const {
+    return static_cast<size_t>(pos.y) * header->width + static_cast<size_t>(pos.x);
+}
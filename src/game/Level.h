@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "LevelFormat.h"
+#include "MappedFile.h"
+
+struct Position;
+
+// Read-only view of a compiled level file. The file is memory-mapped and all
+// accessors read straight from the mapping, so loading does no parsing.
+class Level {
+public:
+    Level();
+    ~Level();
+    
+    Level(const Level&) = delete;
+    Level& operator=(const Level&) = delete;
+    
+    bool load(const std::string& path);
+    void unload();
+    bool isLoaded() const { return header != nullptr; }
+    
+    int getWidth() const { return static_cast<int>(header->width); }
+    int getHeight() const { return static_cast<int>(header->height); }
+    Position getSpawn() const;
+    
+    bool isWall(const Position& pos) const;
+    bool isPortal(const Position& pos) const;
+    bool findPortalExit(const Position& entry, Position& exit) const;
+    size_t getPortalCount() const { return portalCount; }
+    const LevelFormat::LevelPortal& getPortal(size_t index) const { return portals[index]; }
+    
+    // Precomputed distance fields, LevelFormat::UNREACHABLE when absent
+    bool hasWallDistance() const { return wallDistance != nullptr; }
+    bool hasSpawnDistance() const { return spawnDistance != nullptr; }
+    std::uint16_t getWallDistance(const Position& pos) const;
+    std::uint16_t getSpawnDistance(const Position& pos) const;
+    
+private:
+    MappedFile file;
+    
+    const LevelFormat::LevelHeader* header;
+    const unsigned char* wallMask;
+    const LevelFormat::LevelPortal* portals;
+    size_t portalCount;
+    const std::uint16_t* wallDistance;
+    const std::uint16_t* spawnDistance;
+    
+    bool bindSections();
+    size_t cellIndex(const Position& pos) const;
+};
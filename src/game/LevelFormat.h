@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of compiled .snl level files. Everything is little-endian and
+// 4-byte aligned so a mapped file can be read in place without parsing.
+//
+//   LevelHeader
+//   LevelSection[sectionCount]
+//   section payloads (each starting on a 4-byte boundary)
+
+namespace LevelFormat {
+    constexpr char MAGIC[4] = { 'S', 'N', 'L', 'V' };
+    constexpr std::uint32_t VERSION = 1;
+    constexpr std::uint32_t MAX_DIMENSION = 4096;
+    constexpr std::uint16_t UNREACHABLE = 0xFFFF;
+    
+    enum SectionType : std::uint32_t {
+        WALL_MASK = 1,      // 1 bit per cell, row-major, LSB first (required)
+        PORTALS = 2,        // LevelPortal[], one entry per direction of travel
+        WALL_DISTANCE = 3,  // uint16 per cell: BFS steps to the nearest wall or edge
+        SPAWN_DISTANCE = 4  // uint16 per cell: BFS steps from the spawn, UNREACHABLE if cut off
+    };
+    
+    struct LevelHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::int32_t spawnX;
+        std::int32_t spawnY;
+        std::uint32_t sectionCount;
+        std::uint32_t reserved;
+    };
+    
+    struct LevelSection {
+        std::uint32_t type;
+        std::uint32_t offset;   // from the start of the file
+        std::uint32_t size;     // in bytes
+        std::uint32_t reserved;
+    };
+    
+    struct LevelPortal {
+        std::int32_t fromX;
+        std::int32_t fromY;
+        std::int32_t toX;
+        std::int32_t toY;
+    };
+    
+    static_assert(sizeof(LevelHeader) == 32, "LevelHeader must stay 32 bytes");
+    static_assert(sizeof(LevelSection) == 16, "LevelSection must stay 16 bytes");
+    static_assert(sizeof(LevelPortal) == 16, "LevelPortal must stay 16 bytes");
+}
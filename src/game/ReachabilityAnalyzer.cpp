@@ -0,0 +1,500 @@
+#include "ReachabilityAnalyzer.h"
+#include "Level.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+bool ReachabilityAnalyzer::RootSet::contains(int root) const {
+    for (int i = 0; i < count; ++i) {
+        if (roots[i] == root) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReachabilityAnalyzer::RootSet::add(int root) {
+    // A cell has at most four grid and a few portal neighbours
+    if (count < MAX_ROOTS && !contains(root)) {
+        roots[count++] = root;
+    }
+}
+
+ReachabilityAnalyzer::ReachabilityAnalyzer()
+    : game(nullptr)
+    , width(0)
+    , height(0)
+    , syncedTick(0)
+    , epoch(0)
+{
+}
+
+bool ReachabilityAnalyzer::attach(const SnakeGame& target) {
+    detach();
+    
+    if (target.getMode() == GameMode::ENDLESS) {
+        std::cerr << "Reachability analysis needs a bounded board\n";
+        return false;
+    }
+    
+    game = &target;
+    width = target.getBoardWidth();
+    height = target.getBoardHeight();
+    
+    size_t cells = static_cast<size_t>(width) * height;
+    cellNode.assign(cells, NO_NODE);
+    visitEpoch.assign(cells, 0);
+    visitOwner.assign(cells, 0);
+    epoch = 0;
+    
+    buildPortalLinks();
+    rebuild();
+    syncedTick = target.getTick();
+    return true;
+}
+
+void ReachabilityAnalyzer::detach() {
+    game = nullptr;
+    cellNode.clear();
+    parent.clear();
+    rank.clear();
+    freeCount.clear();
+    portalLinks.clear();
+    visitEpoch.clear();
+    visitOwner.clear();
+}
+
+void ReachabilityAnalyzer::sync() {
+    if (!game) {
+        return;
+    }
+    
+    const CellChangeList& changes = game->getCellChanges();
+    std::uint32_t tick = game->getTick();
+    if (tick == syncedTick && !changes.fullRepaint) {
+        return;
+    }
+    
+    // Only the very next tick can be applied from its cell changes
+    if (changes.fullRepaint || tick != syncedTick + 1) {
+        rebuild();
+        syncedTick = tick;
+        return;
+    }
+    
+    for (int i = 0; i < changes.count; ++i) {
+        const CellChange& change = changes.changes[i];
+        if (change.after == CellContent::SNAKE && change.before != CellContent::SNAKE) {
+            occupyCell(cellOf(change.position));
+        } else if (change.before == CellContent::SNAKE && change.after != CellContent::SNAKE) {
+            releaseCell(cellOf(change.position));
+        }
+    }
+    syncedTick = tick;
+    
+    // Every freed cell and every split allocates a node, compact once they pile up
+    if (parent.size() > cellNode.size() * 2 + 64) {
+        rebuild();
+    }
+}
+
+int ReachabilityAnalyzer::reachableArea(Direction move) const {
+    int target;
+    if (!resolveMove(move, target)) {
+        return 0;
+    }
+    
+    // Pieces the head cell splits off all stay adjacent to the head
+    int root = find(cellNode[target]);
+    int area = freeCount[root] - 1;
+    if (target == cellOf(game->getFoodPosition())) {
+        return area;
+    }
+    
+    // The tail moves away and joins whatever regions it touches
+    RootSet around;
+    collectNeighborRoots(cellOf(game->getSnakeBody().back()), around);
+    if (!around.contains(root)) {
+        return area;
+    }
+    area += 1;
+    for (int i = 0; i < around.count; ++i) {
+        if (around.roots[i] != root) {
+            area += freeCount[around.roots[i]];
+        }
+    }
+    return area;
+}
+
+bool ReachabilityAnalyzer::canReachTail(Direction move) const {
+    int target;
+    if (!resolveMove(move, target)) {
+        return false;
+    }
+    
+    int root = find(cellNode[target]);
+    const SnakeBody& body = game->getSnakeBody();
+    int tail = cellOf(body.back());
+    bool found = false;
+    
+    if (target == cellOf(game->getFoodPosition())) {
+        // Eating keeps the tail in place
+        forEachNeighbor(tail, [&](int next) {
+            if (next != target && isFree(next) && find(cellNode[next]) == root) {
+                found = true;
+            }
+        });
+        return found;
+    }
+    
+    RootSet joined;
+    collectNeighborRoots(tail, joined);
+    bool tailJoins = joined.contains(root);
+    
+    int newTail = cellOf(body[body.size() - 2]);
+    forEachNeighbor(newTail, [&](int next) {
+        if (next == tail) {
+            found = found || tailJoins;
+        } else if (next != target && isFree(next)) {
+            int nextRoot = find(cellNode[next]);
+            found = found || nextRoot == root || (tailJoins && joined.contains(nextRoot));
+        }
+    });
+    return found;
+}
+
+template <typename Visit>
+void ReachabilityAnalyzer::forEachNeighbor(int cell, Visit visit) const {
+    int x = cell % width;
+    int y = cell / width;
+    if (x > 0) visit(cell - 1);
+    if (x < width - 1) visit(cell + 1);
+    if (y > 0) visit(cell - width);
+    if (y < height - 1) visit(cell + width);
+    
+    if (!portalLinks.empty()) {
+        auto links = portalLinks.find(cell);
+        if (links != portalLinks.end()) {
+            for (int linked : links->second) {
+                visit(linked);
+            }
+        }
+    }
+}
+
+int ReachabilityAnalyzer::makeNode() {
+    int node = static_cast<int>(parent.size());
+    parent.push_back(node);
+    rank.push_back(0);
+    freeCount.push_back(0);
+    return node;
+}
+
+int ReachabilityAnalyzer::find(int node) const {
+    while (parent[node] != node) {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+    }
+    return node;
+}
+
+void ReachabilityAnalyzer::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) {
+        return;
+    }
+    if (rank[a] < rank[b]) {
+        std::swap(a, b);
+    }
+    parent[b] = a;
+    freeCount[a] += freeCount[b];
+    if (rank[a] == rank[b]) {
+        rank[a]++;
+    }
+}
+
+void ReachabilityAnalyzer::buildPortalLinks() {
+    // Entering a portal lands on its exit, so every cell next to the entry is
+    // linked to the exit
+    portalLinks.clear();
+    const Level* level = game->getLevel();
+    if (!level) {
+        return;
+    }
+    
+    auto link = [this](int from, int to) {
+        std::vector<int>& links = portalLinks[from];
+        if (std::find(links.begin(), links.end(), to) == links.end()) {
+            links.push_back(to);
+        }
+    };
+    
+    for (size_t i = 0; i < level->getPortalCount(); ++i) {
+        const LevelFormat::LevelPortal& portal = level->getPortal(i);
+        int entry = cellOf(Position(portal.fromX, portal.fromY));
+        int exit = cellOf(Position(portal.toX, portal.toY));
+        forEachNeighbor(entry, [&](int neighbor) {
+            if (neighbor != exit && !level->isWall(Position(neighbor % width, neighbor / width))) {
+                link(neighbor, exit);
+                link(exit, neighbor);
+            }
+        });
+    }
+}
+
+void ReachabilityAnalyzer::rebuild() {
+    stats.rebuilds++;
+    parent.clear();
+    rank.clear();
+    freeCount.clear();
+    
+    const Level* level = game->getLevel();
+    for (size_t cell = 0; cell < cellNode.size(); ++cell) {
+        bool wall = level && level->isWall(Position(static_cast<int>(cell) % width, static_cast<int>(cell) / width));
+        cellNode[cell] = wall ? NO_NODE : UNLABELED;
+    }
+    for (const Position& segment : game->getSnakeBody()) {
+        if (segment.x >= 0 && segment.x < width && segment.y >= 0 && segment.y < height) {
+            cellNode[cellOf(segment)] = NO_NODE;
+        }
+    }
+    
+    if (searchQueues.empty()) {
+        searchQueues.resize(1);
+    }
+    std::vector<int>& queue = searchQueues[0];
+    for (size_t start = 0; start < cellNode.size(); ++start) {
+        if (cellNode[start] != UNLABELED) {
+            continue;
+        }
+        
+        int node = makeNode();
+        queue.clear();
+        queue.push_back(static_cast<int>(start));
+        cellNode[start] = node;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            forEachNeighbor(queue[head], [&](int next) {
+                if (cellNode[next] == UNLABELED) {
+                    cellNode[next] = node;
+                    queue.push_back(next);
+                }
+            });
+        }
+        freeCount[node] = static_cast<int>(queue.size());
+    }
+}
+
+void ReachabilityAnalyzer::occupyCell(int cell) {
+    if (!isFree(cell)) {
+        return;
+    }
+    
+    int root = find(cellNode[cell]);
+    freeCount[root]--;
+    cellNode[cell] = NO_NODE;
+    
+    seeds.clear();
+    forEachNeighbor(cell, [this](int next) {
+        if (isFree(next) && std::find(seeds.begin(), seeds.end(), next) == seeds.end()) {
+            seeds.push_back(next);
+        }
+    });
+    
+    if (seeds.size() <= 1 || ringConnected(cell)) {
+        return;
+    }
+    splitSearch(root);
+}
+
+void ReachabilityAnalyzer::releaseCell(int cell) {
+    if (isFree(cell)) {
+        return;
+    }
+    
+    int node = makeNode();
+    freeCount[node] = 1;
+    cellNode[cell] = node;
+    forEachNeighbor(cell, [this, node](int next) {
+        if (isFree(next)) {
+            unite(node, cellNode[next]);
+        }
+    });
+}
+
+bool ReachabilityAnalyzer::ringConnected(int cell) const {
+    // The eight cells around the removed one, in order; consecutive ring cells
+    // are grid neighbours, so seeds on one unbroken run stay connected
+    static const int ringX[8] = { -1, 0, 1, 1, 1, 0, -1, -1 };
+    static const int ringY[8] = { -1, -1, -1, 0, 1, 1, 1, 0 };
+    
+    int x = cell % width;
+    int y = cell / width;
+    bool passable[8];
+    int blockedAt = -1;
+    for (int i = 0; i < 8; ++i) {
+        int rx = x + ringX[i];
+        int ry = y + ringY[i];
+        passable[i] = rx >= 0 && rx < width && ry >= 0 && ry < height && isFree(ry * width + rx);
+        if (!passable[i]) {
+            blockedAt = i;
+        }
+    }
+    
+    // Seeds reached through a portal are not on the ring
+    for (int seed : seeds) {
+        int dx = seed % width - x;
+        int dy = seed / width - y;
+        if (std::abs(dx) + std::abs(dy) != 1) {
+            return false;
+        }
+    }
+    if (blockedAt < 0) {
+        return true;
+    }
+    
+    // Walk once around the ring from a blocked cell and label the runs
+    int run = 0;
+    int seedRun = -1;
+    for (int step = 1; step <= 8; ++step) {
+        int i = (blockedAt + step) % 8;
+        if (!passable[i]) {
+            run++;
+            continue;
+        }
+        if (ringX[i] != 0 && ringY[i] != 0) {
+            continue;
+        }
+        // Edge cell: passable ones are exactly the seeds found on the grid
+        if (seedRun >= 0 && seedRun != run) {
+            return false;
+        }
+        seedRun = run;
+    }
+    return true;
+}
+
+void ReachabilityAnalyzer::splitSearch(int root) {
+    stats.splitSearches++;
+    if (++epoch == 0) {
+        std::fill(visitEpoch.begin(), visitEpoch.end(), 0);
+        epoch = 1;
+    }
+    
+    // One breadth-first search per seed, grouped as they meet
+    int count = std::min(static_cast<int>(seeds.size()), MAX_ROOTS);
+    if (static_cast<int>(searchQueues.size()) < count) {
+        searchQueues.resize(count);
+    }
+    int group[MAX_ROOTS];
+    size_t head[MAX_ROOTS];
+    bool settled[MAX_ROOTS];
+    for (int i = 0; i < count; ++i) {
+        group[i] = i;
+        head[i] = 0;
+        settled[i] = false;
+        searchQueues[i].clear();
+        searchQueues[i].push_back(seeds[i]);
+        visitEpoch[seeds[i]] = epoch;
+        visitOwner[seeds[i]] = static_cast<std::uint8_t>(i);
+    }
+    auto groupOf = [&group](int search) {
+        while (group[search] != search) {
+            search = group[search];
+        }
+        return search;
+    };
+    
+    while (true) {
+        // A group whose searches all ran dry is a region of its own now
+        int open = 0;
+        for (int g = 0; g < count; ++g) {
+            if (groupOf(g) != g || settled[g]) {
+                continue;
+            }
+            bool exhausted = true;
+            for (int i = 0; i < count; ++i) {
+                if (groupOf(i) == g && head[i] < searchQueues[i].size()) {
+                    exhausted = false;
+                }
+            }
+            if (!exhausted) {
+                open++;
+                continue;
+            }
+            
+            settled[g] = true;
+            int node = makeNode();
+            int moved = 0;
+            for (int i = 0; i < count; ++i) {
+                if (groupOf(i) == g) {
+                    for (int cell : searchQueues[i]) {
+                        cellNode[cell] = node;
+                    }
+                    moved += static_cast<int>(searchQueues[i].size());
+                }
+            }
+            freeCount[node] = moved;
+            freeCount[root] -= moved;
+        }
+        if (open <= 1) {
+            return;
+        }
+        
+        for (int i = 0; i < count; ++i) {
+            if (settled[groupOf(i)] || head[i] == searchQueues[i].size()) {
+                continue;
+            }
+            int cell = searchQueues[i][head[i]++];
+            stats.searchedCells++;
+            forEachNeighbor(cell, [&](int next) {
+                if (!isFree(next)) {
+                    return;
+                }
+                if (visitEpoch[next] == epoch) {
+                    int mine = groupOf(i);
+                    int theirs = groupOf(visitOwner[next]);
+                    if (mine != theirs) {
+                        group[std::max(mine, theirs)] = std::min(mine, theirs);
+                    }
+                } else {
+                    visitEpoch[next] = epoch;
+                    visitOwner[next] = static_cast<std::uint8_t>(i);
+                    searchQueues[i].push_back(next);
+                }
+            });
+        }
+    }
+}
+
+bool ReachabilityAnalyzer::resolveMove(Direction move, int& target) const {
+    if (!game || game->isGameOver()) {
+        return false;
+    }
+    
+    Position next = game->getSnakeBody().front();
+    switch (move) {
+        case Direction::UP:    next.y--; break;
+        case Direction::DOWN:  next.y++; break;
+        case Direction::LEFT:  next.x--; break;
+        case Direction::RIGHT: next.x++; break;
+    }
+    if (game->getLevel()) {
+        game->getLevel()->findPortalExit(next, next);
+    }
+    
+    // The tail only moves after the collision check, so it still blocks
+    if (next.x < 0 || next.x >= width || next.y < 0 || next.y >= height || !isFree(cellOf(next))) {
+        return false;
+    }
+    target = cellOf(next);
+    return true;
+}
+
+void ReachabilityAnalyzer::collectNeighborRoots(int cell, RootSet& roots) const {
+    forEachNeighbor(cell, [&](int next) {
+        if (isFree(next)) {
+            roots.add(find(cellNode[next]));
+        }
+    });
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "SnakeGame.h"
+
+// Keeps the connected regions of free cells on a bounded board up to date as
+// the game runs, so move queries only inspect the union-find sets around the
+// head and tail instead of flood filling the board.
+//
+// Freed tail cells are unioned into their neighbours. A cell taken by the head
+// can split its region; a local ring check rules that out in the common case,
+// otherwise searches from each side run in lockstep and stop once all but one
+// side are fully explored, so a split costs the size of the smaller pieces.
+// Portal moves are treated as two-way links.
+class ReachabilityAnalyzer {
+public:
+    struct Stats {
+        size_t rebuilds = 0;        // full relabels after attach, reset or skipped ticks
+        size_t splitSearches = 0;   // head moves the ring check could not settle
+        size_t searchedCells = 0;   // cells expanded by those searches
+    };
+    
+    ReachabilityAnalyzer();
+    
+    // Endless boards are unbounded and cannot be analyzed
+    bool attach(const SnakeGame& game);
+    void detach();
+    bool isAttached() const { return game != nullptr; }
+    
+    // Call once after every update() or reset() of the attached game
+    void sync();
+    
+    // Free cells reachable from the head after taking move, 0 if the move is fatal
+    int reachableArea(Direction move) const;
+    
+    // Whether a free cell next to the tail is still reachable after taking move
+    bool canReachTail(Direction move) const;
+    
+    const Stats& getStats() const { return stats; }
+    
+private:
+    static constexpr int NO_NODE = -1;      // cell is a wall or part of the snake
+    static constexpr int UNLABELED = -2;    // free cell not yet assigned during rebuild
+    static constexpr int MAX_ROOTS = 16;
+    
+    struct RootSet {
+        int roots[MAX_ROOTS];
+        int count = 0;
+        
+        bool contains(int root) const;
+        void add(int root);
+    };
+    
+    const SnakeGame* game;
+    int width;
+    int height;
+    std::uint32_t syncedTick;
+    
+    std::vector<int> cellNode;              // any union-find node of the cell's set
+    mutable std::vector<int> parent;
+    std::vector<std::uint8_t> rank;
+    std::vector<int> freeCount;             // free cells in the set, valid at roots
+    std::unordered_map<int, std::vector<int>> portalLinks;
+    
+    // Split search scratch, reused across ticks
+    std::vector<std::uint32_t> visitEpoch;
+    std::vector<std::uint8_t> visitOwner;
+    std::uint32_t epoch;
+    std::vector<std::vector<int>> searchQueues;
+    std::vector<int> seeds;
+    
+    Stats stats;
+    
+    int cellOf(const Position& pos) const { return pos.y * width + pos.x; }
+    bool isFree(int cell) const { return cellNode[cell] != NO_NODE; }
+    template <typename Visit>
+    void forEachNeighbor(int cell, Visit visit) const;
+    
+    int makeNode();
+    int find(int node) const;
+    void unite(int a, int b);
+    
+    void buildPortalLinks();
+    void rebuild();
+    void occupyCell(int cell);
+    void releaseCell(int cell);
+    bool ringConnected(int cell) const;
+    void splitSearch(int root);
+    
+    bool resolveMove(Direction move, int& target) const;
+    void collectNeighborRoots(int cell, RootSet& roots) const;
+};
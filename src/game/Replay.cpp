@@ -0,0 +1,323 @@
+#include "Replay.h"
+#include "LevelFormat.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static_assert(ReplayFormat::RNG_STATE_WORDS == GameRng::STATE_WORDS,
+              "replay keyframes store the whole GameRng state");
+
+ReplayWriter::ReplayWriter()
+    : offset(0)
+    , keyframeInterval(ReplayFormat::DEFAULT_KEYFRAME_INTERVAL)
+    , tickCount(0)
+{
+}
+
+ReplayWriter::~ReplayWriter() {
+    finish();
+}
+
+bool ReplayWriter::open(const std::string& path, const SnakeGame& game, std::uint32_t interval) {
+    using namespace ReplayFormat;
+    
+    finish();
+    
+    if (game.getLevel()) {
+        std::cerr << "Games on custom levels cannot be recorded\n";
+        return false;
+    }
+    
+    output.open(path, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        std::cerr << "Could not create replay file: " << path << "\n";
+        return false;
+    }
+    
+    ReplayHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.mode = static_cast<std::uint32_t>(game.getMode());
+    header.boardWidth = game.getBoardWidth();
+    header.boardHeight = game.getBoardHeight();
+    header.keyframeInterval = std::max<std::uint32_t>(1, interval);
+    
+    offset = 0;
+    keyframeInterval = header.keyframeInterval;
+    tickCount = game.getTick();
+    index.clear();
+    
+    write(&header, sizeof(header));
+    writeKeyframe(game);
+    return static_cast<bool>(output);
+}
+
+void ReplayWriter::recordTick(const SnakeGame& game) {
+    if (!isOpen() || game.getTick() == tickCount) {
+        return;
+    }
+    
+    tickCount = game.getTick();
+    std::uint8_t direction = static_cast<std::uint8_t>(game.getCurrentDirection());
+    write(&direction, sizeof(direction));
+    index.back().inputCount++;
+    
+    if (!game.isGameOver() && tickCount % keyframeInterval == 0) {
+        writeKeyframe(game);
+    }
+}
+
+bool ReplayWriter::finish() {
+    using namespace ReplayFormat;
+    
+    if (!isOpen()) {
+        return false;
+    }
+    
+    // The index holds 64-bit offsets, keep it and the footer 8-byte aligned
+    pad(8);
+    ReplayFooter footer = {};
+    footer.indexOffset = offset;
+    footer.indexCount = static_cast<std::uint32_t>(index.size());
+    footer.tickCount = tickCount;
+    std::memcpy(footer.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    
+    write(index.data(), index.size() * sizeof(KeyframeIndexEntry));
+    write(&footer, sizeof(footer));
+    
+    bool written = static_cast<bool>(output);
+    output.close();
+    if (!written) {
+        std::cerr << "Failed to write replay file\n";
+    }
+    return written;
+}
+
+void ReplayWriter::write(const void* data, size_t bytes) {
+    output.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    offset += bytes;
+}
+
+void ReplayWriter::pad(size_t alignment) {
+    static const char zeros[8] = {};
+    size_t remainder = static_cast<size_t>(offset % alignment);
+    if (remainder != 0) {
+        write(zeros, alignment - remainder);
+    }
+}
+
+void ReplayWriter::writeKeyframe(const SnakeGame& game) {
+    using namespace ReplayFormat;
+    
+    pad(4);
+    game.captureSnapshot(snapshot);
+    
+    KeyframeIndexEntry entry = {};
+    entry.tick = snapshot.tick;
+    entry.keyframeOffset = offset;
+    
+    KeyframeRecord record = {};
+    record.tick = snapshot.tick;
+    record.bodyLength = static_cast<std::uint32_t>(snapshot.body.size());
+    record.foodX = snapshot.food.x;
+    record.foodY = snapshot.food.y;
+    record.score = snapshot.score;
+    record.currentDirection = static_cast<std::uint8_t>(snapshot.currentDirection);
+    record.nextDirection = static_cast<std::uint8_t>(snapshot.nextDirection);
+    record.gameOver = snapshot.gameOver ? 1 : 0;
+    record.rngIndex = snapshot.rngIndex;
+    write(&record, sizeof(record));
+    
+    for (const Position& segment : snapshot.body) {
+        ReplayPosition position = { segment.x, segment.y };
+        write(&position, sizeof(position));
+    }
+    write(snapshot.rngState.data(), sizeof(snapshot.rngState));
+    
+    entry.inputsOffset = offset;
+    index.push_back(entry);
+}
+
+ReplayReader::ReplayReader()
+    : header(nullptr)
+    , index(nullptr)
+    , indexCount(0)
+    , tickCount(0)
+{
+}
+
+bool ReplayReader::load(const std::string& path) {
+    unload();
+    
+    if (!file.open(path)) {
+        std::cerr << "Could not map replay file: " << path << "\n";
+        return false;
+    }
+    
+    if (!bindIndex()) {
+        std::cerr << "Invalid replay file: " << path << "\n";
+        unload();
+        return false;
+    }
+    
+    return true;
+}
+
+void ReplayReader::unload() {
+    file.close();
+    header = nullptr;
+    index = nullptr;
+    indexCount = 0;
+    tickCount = 0;
+}
+
+bool ReplayReader::seek(SnakeGame& game, std::uint32_t tick) {
+    tick = std::max(getFirstTick(), std::min(tick, tickCount));
+    
+    const ReplayFormat::KeyframeIndexEntry* entry = findSegment(tick);
+    if (!restoreKeyframe(game, *entry)) {
+        return false;
+    }
+    
+    // At most one keyframe interval of ticks to replay
+    while (game.getTick() < tick) {
+        if (!step(game)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ReplayReader::step(SnakeGame& game) const {
+    std::uint32_t tick = game.getTick();
+    if (tick >= tickCount || tick < getFirstTick()) {
+        return false;
+    }
+    
+    const ReplayFormat::KeyframeIndexEntry* entry = findSegment(tick);
+    std::uint32_t input = tick - entry->tick;
+    if (input >= entry->inputCount) {
+        return false;
+    }
+    
+    std::uint8_t direction = file.data()[entry->inputsOffset + input];
+    if (direction > static_cast<std::uint8_t>(Direction::RIGHT)) {
+        return false;
+    }
+    
+    game.setDirection(static_cast<Direction>(direction));
+    game.update();
+    return game.getTick() == tick + 1;
+}
+
+bool ReplayReader::bindIndex() {
+    using namespace ReplayFormat;
+    
+    const unsigned char* data = file.data();
+    size_t size = file.size();
+    if (size < sizeof(ReplayHeader) + sizeof(ReplayFooter) || size % 8 != 0) {
+        return false;
+    }
+    
+    const auto* candidate = reinterpret_cast<const ReplayHeader*>(data);
+    if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        candidate->version != VERSION ||
+        candidate->mode > static_cast<std::uint32_t>(GameMode::ENDLESS) ||
+        candidate->keyframeInterval == 0) {
+        return false;
+    }
+    
+    // Replay games preallocate the board, so bound it before anyone trusts it
+    if (static_cast<GameMode>(candidate->mode) == GameMode::ENDLESS) {
+        if (candidate->boardWidth != SnakeGame::ENDLESS_BOARD_SIZE ||
+            candidate->boardHeight != SnakeGame::ENDLESS_BOARD_SIZE) {
+            return false;
+        }
+    } else if (candidate->boardWidth <= 0 || candidate->boardHeight <= 0 ||
+               candidate->boardWidth > static_cast<std::int32_t>(LevelFormat::MAX_DIMENSION) ||
+               candidate->boardHeight > static_cast<std::int32_t>(LevelFormat::MAX_DIMENSION)) {
+        return false;
+    }
+    
+    const auto* footer = reinterpret_cast<const ReplayFooter*>(data + size - sizeof(ReplayFooter));
+    size_t indexEnd = size - sizeof(ReplayFooter);
+    if (std::memcmp(footer->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+        footer->indexCount == 0 || footer->indexOffset % 8 != 0 ||
+        footer->indexOffset < sizeof(ReplayHeader) || footer->indexOffset > indexEnd ||
+        (indexEnd - footer->indexOffset) != static_cast<size_t>(footer->indexCount) * sizeof(KeyframeIndexEntry)) {
+        return false;
+    }
+    
+    // Segments must be back to back in tick order and stay in front of the index
+    const auto* entries = reinterpret_cast<const KeyframeIndexEntry*>(data + footer->indexOffset);
+    for (std::uint32_t i = 0; i < footer->indexCount; ++i) {
+        const KeyframeIndexEntry& entry = entries[i];
+        if (entry.keyframeOffset % 4 != 0 || entry.keyframeOffset < sizeof(ReplayHeader) ||
+            entry.inputsOffset > footer->indexOffset ||
+            entry.keyframeOffset > entry.inputsOffset ||
+            entry.inputsOffset - entry.keyframeOffset < sizeof(KeyframeRecord) ||
+            entry.inputCount > footer->indexOffset - entry.inputsOffset) {
+            return false;
+        }
+        if (i > 0) {
+            const KeyframeIndexEntry& previous = entries[i - 1];
+            if (entry.tick != previous.tick + previous.inputCount ||
+                entry.keyframeOffset < previous.inputsOffset + previous.inputCount) {
+                return false;
+            }
+        }
+    }
+    
+    const KeyframeIndexEntry& last = entries[footer->indexCount - 1];
+    if (last.tick + last.inputCount != footer->tickCount) {
+        return false;
+    }
+    
+    header = candidate;
+    index = entries;
+    indexCount = footer->indexCount;
+    tickCount = footer->tickCount;
+    return true;
+}
+
+const ReplayFormat::KeyframeIndexEntry* ReplayReader::findSegment(std::uint32_t tick) const {
+    // Last keyframe at or before tick
+    const ReplayFormat::KeyframeIndexEntry* end = index + indexCount;
+    const ReplayFormat::KeyframeIndexEntry* next = std::upper_bound(index, end, tick,
+        [](std::uint32_t value, const ReplayFormat::KeyframeIndexEntry& entry) {
+            return value < entry.tick;
+        });
+    return next == index ? index : next - 1;
+}
+
+bool ReplayReader::restoreKeyframe(SnakeGame& game, const ReplayFormat::KeyframeIndexEntry& entry) {
+    using namespace ReplayFormat;
+    
+    const unsigned char* data = file.data() + entry.keyframeOffset;
+    const auto* record = reinterpret_cast<const KeyframeRecord*>(data);
+    std::uint64_t available = entry.inputsOffset - entry.keyframeOffset - sizeof(KeyframeRecord);
+    std::uint64_t bodyBytes = static_cast<std::uint64_t>(record->bodyLength) * sizeof(ReplayPosition);
+    std::uint8_t lastDirection = static_cast<std::uint8_t>(Direction::RIGHT);
+    if (record->tick != entry.tick || record->bodyLength == 0 ||
+        bodyBytes + RNG_STATE_WORDS * sizeof(std::uint32_t) > available ||
+        record->rngIndex > RNG_STATE_WORDS ||
+        record->currentDirection > lastDirection || record->nextDirection > lastDirection) {
+        return false;
+    }
+    
+    const auto* body = reinterpret_cast<const ReplayPosition*>(data + sizeof(KeyframeRecord));
+    snapshot.body.clear();
+    for (std::uint32_t i = 0; i < record->bodyLength; ++i) {
+        snapshot.body.push_back(Position(body[i].x, body[i].y));
+    }
+    snapshot.food = Position(record->foodX, record->foodY);
+    snapshot.currentDirection = static_cast<Direction>(record->currentDirection);
+    snapshot.nextDirection = static_cast<Direction>(record->nextDirection);
+    snapshot.gameOver = record->gameOver != 0;
+    snapshot.score = record->score;
+    snapshot.tick = record->tick;
+    std::memcpy(snapshot.rngState.data(), body + record->bodyLength, sizeof(snapshot.rngState));
+    snapshot.rngIndex = record->rngIndex;
+    
+    return game.restoreSnapshot(snapshot);
+}
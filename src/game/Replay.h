@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "ReplayFormat.h"
+#include "SnakeGame.h"
+
+// Streams a game into a replay file: the direction taken on every tick plus a
+// full-state keyframe every keyframeInterval ticks. Games on custom levels are
+// not recorded since the level itself is not part of the file.
+class ReplayWriter {
+public:
+    ReplayWriter();
+    ~ReplayWriter();
+    
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+    
+    bool open(const std::string& path, const SnakeGame& game,
+              std::uint32_t keyframeInterval = ReplayFormat::DEFAULT_KEYFRAME_INTERVAL);
+    bool isOpen() const { return output.is_open(); }
+    
+    // Call after every update() of the recorded game
+    void recordTick(const SnakeGame& game);
+    
+    // Appends the keyframe index, also done on destruction
+    bool finish();
+    
+private:
+    void write(const void* data, size_t bytes);
+    void pad(size_t alignment);
+    void writeKeyframe(const SnakeGame& game);
+    
+    std::ofstream output;
+    std::uint64_t offset;
+    std::uint32_t keyframeInterval;
+    std::uint32_t tickCount;
+    std::vector<ReplayFormat::KeyframeIndexEntry> index;
+    GameSnapshot snapshot;
+};
+
+// Memory-mapped replay with random access. Seeking restores the closest
+// keyframe at or before the target and re-simulates at most one keyframe
+// interval of ticks, so any position is reached in constant time.
+class ReplayReader {
+public:
+    ReplayReader();
+    
+    ReplayReader(const ReplayReader&) = delete;
+    ReplayReader& operator=(const ReplayReader&) = delete;
+    
+    bool load(const std::string& path);
+    void unload();
+    bool isLoaded() const { return header != nullptr; }
+    
+    GameMode getMode() const { return static_cast<GameMode>(header->mode); }
+    int getBoardWidth() const { return header->boardWidth; }
+    int getBoardHeight() const { return header->boardHeight; }
+    std::uint32_t getKeyframeInterval() const { return header->keyframeInterval; }
+    size_t getKeyframeCount() const { return indexCount; }
+    std::uint32_t getFirstTick() const { return index[0].tick; }
+    std::uint32_t getTickCount() const { return tickCount; }
+    
+    // Puts game at the given tick, clamped to the recorded range
+    bool seek(SnakeGame& game, std::uint32_t tick);
+    
+    // Plays the next recorded tick, false at the end of the replay
+    bool step(SnakeGame& game) const;
+    
+private:
+    MappedFile file;
+    
+    const ReplayFormat::ReplayHeader* header;
+    const ReplayFormat::KeyframeIndexEntry* index;
+    size_t indexCount;
+    std::uint32_t tickCount;
+    GameSnapshot snapshot;
+    
+    bool bindIndex();
+    const ReplayFormat::KeyframeIndexEntry* findSegment(std::uint32_t tick) const;
+    bool restoreKeyframe(SnakeGame& game, const ReplayFormat::KeyframeIndexEntry& entry);
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of .snr replay files, with the same byte order and alignment
+// rules as the level files in LevelFormat.h.
+//
+//   ReplayHeader
+//   segments, each one:
+//     KeyframeRecord, ReplayPosition[bodyLength], uint32 RNG state[RNG_STATE_WORDS]
+//     one direction byte per tick until the next keyframe (padded to 4)
+//   KeyframeIndexEntry[indexCount] (8-byte aligned)
+//   ReplayFooter (last bytes of the file)
+//
+// The writer streams segments as the game runs and appends the index when it
+// finishes, so readers find every keyframe from the footer without scanning.
+
+namespace ReplayFormat {
+    constexpr char MAGIC[4] = { 'S', 'N', 'R', 'P' };
+    constexpr char INDEX_MAGIC[4] = { 'S', 'N', 'R', 'I' };
+    constexpr std::uint32_t VERSION = 2;
+    constexpr std::uint32_t DEFAULT_KEYFRAME_INTERVAL = 256;   // ticks between keyframes
+    constexpr std::uint32_t RNG_STATE_WORDS = 624;             // Mersenne Twister state
+    
+    struct ReplayHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t mode;             // GameMode
+        std::int32_t boardWidth;
+        std::int32_t boardHeight;
+        std::uint32_t keyframeInterval;
+        std::uint32_t reserved[2];
+    };
+    
+    struct KeyframeRecord {
+        std::uint32_t tick;
+        std::uint32_t bodyLength;
+        std::int32_t foodX;
+        std::int32_t foodY;
+        std::int32_t score;
+        std::uint8_t currentDirection;  // Direction
+        std::uint8_t nextDirection;
+        std::uint8_t gameOver;
+        std::uint8_t reserved;
+        std::uint32_t rngIndex;         // next state word the generator reads
+    };
+    
+    struct ReplayPosition {
+        std::int32_t x;
+        std::int32_t y;
+    };
+    
+    struct KeyframeIndexEntry {
+        std::uint32_t tick;
+        std::uint32_t inputCount;       // ticks recorded after this keyframe
+        std::uint64_t keyframeOffset;   // from the start of the file
+        std::uint64_t inputsOffset;
+    };
+    
+    struct ReplayFooter {
+        std::uint64_t indexOffset;
+        std::uint32_t indexCount;
+        std::uint32_t tickCount;        // tick of the last recorded update
+        std::uint32_t reserved;
+        char magic[4];
+    };
+    
+    static_assert(sizeof(ReplayHeader) == 32, "ReplayHeader must stay 32 bytes");
+    static_assert(sizeof(KeyframeRecord) == 28, "KeyframeRecord must stay 28 bytes");
+    static_assert(sizeof(ReplayPosition) == 8, "ReplayPosition must stay 8 bytes");
+    static_assert(sizeof(KeyframeIndexEntry) == 24, "KeyframeIndexEntry must stay 24 bytes");
+    static_assert(sizeof(ReplayFooter) == 24, "ReplayFooter must stay 24 bytes");
+}
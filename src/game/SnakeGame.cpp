@@ -1,30 +1,74 @@
 #include "SnakeGame.h"
+#include "Level.h"
 #include <algorithm>
 
-SnakeGame::SnakeGame() 
-    : currentDirection(Direction::RIGHT)
+SnakeGame::SnakeGame(GameMode mode) 
+    : SnakeGame(mode, nullptr,
+                mode == GameMode::ENDLESS ? ENDLESS_BOARD_SIZE : BOARD_WIDTH,
+                mode == GameMode::ENDLESS ? ENDLESS_BOARD_SIZE : BOARD_HEIGHT)
+{
+}
+
+SnakeGame::SnakeGame(const Level& level)
+    : SnakeGame(GameMode::CLASSIC, &level, level.getWidth(), level.getHeight())
+{
+}
+
+SnakeGame::SnakeGame(int boardWidth, int boardHeight)
+    : SnakeGame(GameMode::CLASSIC, nullptr, boardWidth, boardHeight)
+{
+}
+
+SnakeGame::SnakeGame(GameMode mode, const Level* level, int width, int height)
+    : mode(mode)
+    , level(level)
+    , boardWidth(width)
+    , boardHeight(height)
+    , currentDirection(Direction::RIGHT)
     , nextDirection(Direction::RIGHT)
     , gameOver(false)
     , score(0)
+    , tick(0)
     , rng(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()))
-    , xDist(0, BOARD_WIDTH - 1)
-    , yDist(0, BOARD_HEIGHT - 1)
+    , xDist(0, boardWidth - 1)
+    , yDist(0, boardHeight - 1)
 {
+    if (mode != GameMode::ENDLESS) {
+        world.preallocate(boardWidth, boardHeight);
+    }
     reset();
 }
 
 void SnakeGame::reset() {
+    // Size the body for the whole board up front so it never grows mid-game;
+    // clear() keeps the buffer, so later resets reuse it
+    size_t cells = mode == GameMode::ENDLESS ? ENDLESS_INITIAL_BODY
+                                             : static_cast<size_t>(boardWidth) * boardHeight;
+    size_t capacity = BodyPool::blockSize(cells * sizeof(Position)) / sizeof(Position);
     snake.clear();
-    snake.push_back(Position(BOARD_WIDTH / 2, BOARD_HEIGHT / 2));
-    snake.push_back(Position(BOARD_WIDTH / 2 - 1, BOARD_HEIGHT / 2));
-    snake.push_back(Position(BOARD_WIDTH / 2 - 2, BOARD_HEIGHT / 2));
+    if (snake.capacity() < capacity) {
+        snake.reserve(capacity);
+        trackBodyCapacity();
+    }
+    world.clear();
+    Position spawn = level ? level->getSpawn() : Position(boardWidth / 2, boardHeight / 2);
+    for (int i = 0; i < 3; ++i) {
+        snake.push_back(Position(spawn.x - i, spawn.y));
+        world.occupy(snake.back());
+    }
     
     currentDirection = Direction::RIGHT;
     nextDirection = Direction::RIGHT;
     gameOver = false;
     score = 0;
+    tick = 0;
+    cellChanges.count = 0;
+    cellChanges.fullRepaint = true;
+    
+    gameOver = !generateFood();
     
-    generateFood();
+    publish(GameEvent::Type::RESET);
+    publish(GameEvent::Type::FOOD_SPAWNED);
 }
 
 bool SnakeGame::update() {
@@ -34,25 +78,142 @@ bool SnakeGame::update() {
     
     currentDirection = nextDirection;
     moveSnake();
+    tick++;
+    cellChanges.count = 0;
+    cellChanges.fullRepaint = false;
     
     if (checkCollision()) {
         gameOver = true;
+        publish(GameEvent::Type::DIED);
         return false;
     }
     
+    world.occupy(snake[0]);
+    
     // Check if food is eaten
     if (snake[0] == food) {
+        cellChanges.push(snake[0], CellContent::FOOD, CellContent::SNAKE);
         score += 10;
-        generateFood();
+        publish(GameEvent::Type::MOVED);
+        publish(GameEvent::Type::ATE_FOOD);
+        publish(GameEvent::Type::SCORE_CHANGED);
+        
+        // A snake filling every free spot leaves nowhere to place new food
+        if (!generateFood()) {
+            gameOver = true;
+            publish(GameEvent::Type::DIED);
+            return false;
+        }
+        cellChanges.push(food, CellContent::EMPTY, CellContent::FOOD);
+        publish(GameEvent::Type::FOOD_SPAWNED);
         // Don't remove tail - snake grows
     } else {
         // Remove tail - normal movement
+        Position tail = snake.back();
+        world.release(tail);
         snake.pop_back();
+        cellChanges.push(snake[0], CellContent::EMPTY, CellContent::SNAKE);
+        cellChanges.push(tail, CellContent::SNAKE, CellContent::EMPTY);
+        publish(GameEvent::Type::MOVED, true, tail);
+    }
+    
+    // Bounded boards keep every chunk so steady-state ticks never allocate;
+    // the endless world sweeps stale chunks when the head crosses a boundary
+    const Position& previous = snake[1];
+    if (mode == GameMode::ENDLESS &&
+        (ChunkedWorld::chunkCoord(previous.x) != ChunkedWorld::chunkCoord(snake[0].x) ||
+         ChunkedWorld::chunkCoord(previous.y) != ChunkedWorld::chunkCoord(snake[0].y))) {
+        world.evictDistant(snake[0]);
+    }
+    
+    return true;
+}
+
+void SnakeGame::captureSnapshot(GameSnapshot& snapshot) const {
+    snapshot.body.assign(snake.begin(), snake.end());
+    snapshot.food = food;
+    snapshot.currentDirection = currentDirection;
+    snapshot.nextDirection = nextDirection;
+    snapshot.gameOver = gameOver;
+    snapshot.score = score;
+    snapshot.tick = tick;
+    snapshot.rngState = rng.getState();
+    snapshot.rngIndex = rng.getIndex();
+}
+
+bool SnakeGame::restoreSnapshot(const GameSnapshot& snapshot) {
+    if (snapshot.body.empty() || !rng.setState(snapshot.rngState, snapshot.rngIndex)) {
+        return false;
     }
     
+    size_t capacity = BodyPool::blockSize(snapshot.body.size() * sizeof(Position)) / sizeof(Position);
+    if (snake.capacity() < capacity) {
+        snake.reserve(capacity);
+        trackBodyCapacity();
+    }
+    snake.assign(snapshot.body.begin(), snapshot.body.end());
+    world.clear();
+    for (const Position& segment : snake) {
+        world.occupy(segment);
+    }
+    if (mode == GameMode::ENDLESS) {
+        world.evictDistant(snake[0]);
+    }
+    
+    food = snapshot.food;
+    currentDirection = snapshot.currentDirection;
+    nextDirection = snapshot.nextDirection;
+    gameOver = snapshot.gameOver;
+    score = snapshot.score;
+    tick = snapshot.tick;
+    cellChanges.count = 0;
+    cellChanges.fullRepaint = true;
+    
+    publish(GameEvent::Type::RESET);
+    publish(GameEvent::Type::FOOD_SPAWNED);
     return true;
 }
 
+bool SnakeGame::subscribe(GameEventQueue& queue) {
+    if (subscribers.count == MAX_EVENT_SUBSCRIBERS) {
+        return false;
+    }
+    subscribers.queues[subscribers.count++] = &queue;
+    return true;
+}
+
+void SnakeGame::unsubscribe(GameEventQueue& queue) {
+    for (int i = 0; i < subscribers.count; ++i) {
+        if (subscribers.queues[i] == &queue) {
+            subscribers.queues[i] = subscribers.queues[--subscribers.count];
+            return;
+        }
+    }
+}
+
+void SnakeGame::publish(GameEvent::Type type, bool tailRemoved, const Position& tail) {
+    if (subscribers.count == 0) {
+        return;
+    }
+    
+    GameEvent event;
+    event.type = type;
+    event.tailRemoved = tailRemoved;
+    event.tick = tick;
+    event.headX = snake[0].x;
+    event.headY = snake[0].y;
+    event.tailX = tail.x;
+    event.tailY = tail.y;
+    event.foodX = food.x;
+    event.foodY = food.y;
+    event.score = score;
+    
+    // A slow consumer only loses its own events, the tick never waits
+    for (int i = 0; i < subscribers.count; ++i) {
+        subscribers.queues[i]->tryPush(event);
+    }
+}
+
 void SnakeGame::setDirection(Direction newDirection) {
     // Prevent reversing into itself
     if ((currentDirection == Direction::UP && newDirection == Direction::DOWN) ||
@@ -65,38 +226,115 @@ void SnakeGame::setDirection(Direction newDirection) {
     nextDirection = newDirection;
 }
 
-void SnakeGame::generateFood() {
-    do {
-        food.x = xDist(rng);
-        food.y = yDist(rng);
-    } while (isFoodOnSnake());
+bool SnakeGame::generateFood() {
+    // Random tries settle almost every placement; crowded boards fall back to a scan
+    for (int attempt = 0; attempt < FOOD_PLACEMENT_ATTEMPTS; ++attempt) {
+        Position candidate;
+        if (mode == GameMode::ENDLESS) {
+            // Spawn near the head so food never drags in chunks far from the action
+            std::uniform_int_distribution<int> offset(-ENDLESS_FOOD_RADIUS, ENDLESS_FOOD_RADIUS);
+            candidate.x = std::max(0, std::min(boardWidth - 1, snake[0].x + offset(rng)));
+            candidate.y = std::max(0, std::min(boardHeight - 1, snake[0].y + offset(rng)));
+        } else {
+            candidate.x = xDist(rng);
+            candidate.y = yDist(rng);
+        }
+        // Random picks keep clear of level walls when the level ships a wall
+        // field; the scan below still takes any free cell on narrow levels
+        if (isFoodSpot(candidate) && (!level || level->getWallDistance(candidate) >= FOOD_WALL_CLEARANCE)) {
+            food = candidate;
+            return true;
+        }
+    }
+    
+    if (mode != GameMode::ENDLESS) {
+        return placeFoodInArea(0, 0, boardWidth - 1, boardHeight - 1);
+    }
+    
+    // Widen the window around the head until it holds a free cell
+    int maxRadius = std::max(boardWidth, boardHeight);
+    for (int radius = ENDLESS_FOOD_RADIUS; ; radius = std::min(radius * 2, maxRadius)) {
+        if (placeFoodInArea(std::max(0, snake[0].x - radius), std::max(0, snake[0].y - radius),
+                            std::min(boardWidth - 1, snake[0].x + radius),
+                            std::min(boardHeight - 1, snake[0].y + radius))) {
+            return true;
+        }
+        if (radius == maxRadius) {
+            return false;
+        }
+    }
 }
 
-bool SnakeGame::isFoodOnSnake() const {
-    return std::find(snake.begin(), snake.end(), food) != snake.end();
+bool SnakeGame::placeFoodInArea(int left, int top, int right, int bottom) {
+    // Two passes pick uniformly among the free spots without storing them
+    long spots = 0;
+    for (int y = top; y <= bottom; ++y) {
+        for (int x = left; x <= right; ++x) {
+            if (isFoodSpot(Position(x, y))) {
+                spots++;
+            }
+        }
+    }
+    if (spots == 0) {
+        return false;
+    }
+    
+    long pick = std::uniform_int_distribution<long>(0, spots - 1)(rng);
+    for (int y = top; y <= bottom; ++y) {
+        for (int x = left; x <= right; ++x) {
+            if (isFoodSpot(Position(x, y)) && pick-- == 0) {
+                food = Position(x, y);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool SnakeGame::isFoodSpot(const Position& pos) const {
+    return !world.isOccupied(pos) && (!level || isFoodSpotOnLevel(pos));
+}
+
+bool SnakeGame::isFoodSpotOnLevel(const Position& pos) const {
+    if (level->isWall(pos) || level->isPortal(pos)) {
+        return false;
+    }
+    // Skip pockets the snake can never reach when the level ships a spawn field
+    return !level->hasSpawnDistance() || level->getSpawnDistance(pos) != LevelFormat::UNREACHABLE;
 }
 
 void SnakeGame::moveSnake() {
     Position newHead = getNextHeadPosition();
+    if (level) {
+        level->findPortalExit(newHead, newHead);
+    }
     snake.insert(snake.begin(), newHead);
+    trackBodyCapacity();
+}
+
+void SnakeGame::trackBodyCapacity() {
+    // Capacity only ever grows, so every increase is a new buffer
+    size_t bytes = snake.capacity() * sizeof(Position);
+    if (bytes > bodyStats.peakBytes) {
+        bodyStats.allocations++;
+        bodyStats.peakBytes = bytes;
+    }
 }
 
 bool SnakeGame::checkCollision() const {
     const Position& head = snake[0];
     
     // Wall collision
-    if (head.x < 0 || head.x >= BOARD_WIDTH || head.y < 0 || head.y >= BOARD_HEIGHT) {
+    if (head.x < 0 || head.x >= boardWidth || head.y < 0 || head.y >= boardHeight) {
         return true;
     }
     
-    // Self collision (check against body, starting from index 1)
-    for (size_t i = 1; i < snake.size(); ++i) {
-        if (head == snake[i]) {
-            return true;
-        }
+    if (level && level->isWall(head)) {
+        return true;
     }
     
-    return false;
+    // Self collision - the head is not marked in the world yet, so any hit is the body
+    return world.isOccupied(head);
 }
 
 Position SnakeGame::getNextHeadPosition() const {
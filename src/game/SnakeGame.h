@@ -1,13 +1,26 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <random>
 #include <chrono>
 
+#include "BodyPool.h"
+#include "ChunkedWorld.h"
+#include "GameEvents.h"
+#include "GameRng.h"
+
+class Level;
+
 enum class Direction {
     UP, DOWN, LEFT, RIGHT
 };
 
+enum class GameMode {
+    CLASSIC,    // Fixed 40x20 board
+    ENDLESS     // Effectively unbounded board backed by a sparse chunked world
+};
+
 struct Position {
     int x, y;
     
@@ -18,13 +31,78 @@ struct Position {
     }
 };
 
+enum class CellContent : unsigned char {
+    EMPTY, SNAKE, FOOD
+};
+
+struct CellChange {
+    Position position;
+    CellContent before;
+    CellContent after;
+};
+
+// Cells touched by the last tick. A tick changes at most the new head, the
+// removed tail and the food, so the list never allocates.
+struct CellChangeList {
+    static constexpr int CAPACITY = 4;
+    
+    std::array<CellChange, CAPACITY> changes;
+    int count = 0;
+    bool fullRepaint = true;    // set by reset(), consumers must redraw everything
+    
+    void push(const Position& position, CellContent before, CellContent after) {
+        if (count < CAPACITY) {
+            changes[count++] = { position, before, after };
+        } else {
+            fullRepaint = true;
+        }
+    }
+};
+
+using SnakeBody = std::vector<Position, BodyAllocator<Position>>;
+
+// Full game state between two ticks. The occupancy world is derived from the
+// body, so it is rebuilt on restore instead of being stored.
+struct GameSnapshot {
+    std::vector<Position> body;
+    Position food;
+    Direction currentDirection = Direction::RIGHT;
+    Direction nextDirection = Direction::RIGHT;
+    bool gameOver = false;
+    int score = 0;
+    std::uint32_t tick = 0;
+    std::array<std::uint32_t, GameRng::STATE_WORDS> rngState{};
+    std::uint32_t rngIndex = GameRng::STATE_WORDS;
+};
+
 class SnakeGame {
 public:
     static constexpr int BOARD_WIDTH = 40;
     static constexpr int BOARD_HEIGHT = 20;
+    static constexpr int ENDLESS_BOARD_SIZE = 1 << 24;
+    static constexpr int ENDLESS_FOOD_RADIUS = 12;
+    static constexpr int FOOD_PLACEMENT_ATTEMPTS = 64;
+    static constexpr int FOOD_WALL_CLEARANCE = 2;   // preferred steps between food and a level wall
+    static constexpr int MAX_EVENT_SUBSCRIBERS = 8;
+    static constexpr size_t ENDLESS_INITIAL_BODY = 1024;
+    
+    struct BodyStats {
+        size_t allocations = 0;     // body buffer (re)allocations over the game's lifetime
+        size_t peakBytes = 0;
+    };
+    
+    explicit SnakeGame(GameMode mode = GameMode::CLASSIC);
+    explicit SnakeGame(const Level& level);
+    SnakeGame(int boardWidth, int boardHeight);   // Classic rules on a custom board
+    
+    // Move-only: a copy would become a second producer on the subscribed queues
+    SnakeGame(const SnakeGame&) = delete;
+    SnakeGame& operator=(const SnakeGame&) = delete;
+    SnakeGame(SnakeGame&&) = default;
+    SnakeGame& operator=(SnakeGame&&) = default;
     
-    SnakeGame();
     void reset();
+    void setSeed(std::uint32_t seed) { rng.seed(seed); }
     bool update();
     bool isGameOver() const { return gameOver; }
     int getScore() const { return score; }
@@ -32,26 +110,75 @@ public:
     void setDirection(Direction newDirection);
     Direction getCurrentDirection() const { return currentDirection; }
     
-    const std::vector<Position>& getSnakeBody() const { return snake; }
+    const SnakeBody& getSnakeBody() const { return snake; }
+    bool isSnakeAt(const Position& pos) const { return world.isOccupied(pos); }
+    const BodyStats& getBodyStats() const { return bodyStats; }
     const Position& getFoodPosition() const { return food; }
     
-    int getBoardWidth() const { return BOARD_WIDTH; }
-    int getBoardHeight() const { return BOARD_HEIGHT; }
+    int getBoardWidth() const { return boardWidth; }
+    int getBoardHeight() const { return boardHeight; }
+    GameMode getMode() const { return mode; }
+    const Level* getLevel() const { return level; }
+    size_t getChunkCount() const { return world.getChunkCount(); }
+    std::uint32_t getTick() const { return tick; }
+    const CellChangeList& getCellChanges() const { return cellChanges; }
+    
+    // Snapshots for replays - restoring publishes RESET like a new game
+    void captureSnapshot(GameSnapshot& snapshot) const;
+    bool restoreSnapshot(const GameSnapshot& snapshot);
+    
+    // Event subscribers - call from the thread that drives update()
+    bool subscribe(GameEventQueue& queue);
+    void unsubscribe(GameEventQueue& queue);
     
 private:
-    std::vector<Position> snake;
+    SnakeGame(GameMode mode, const Level* level, int width, int height);
+    
+    GameMode mode;
+    const Level* level;
+    int boardWidth;
+    int boardHeight;
+    
+    SnakeBody snake;
+    BodyStats bodyStats;
+    ChunkedWorld world;
     Position food;
     Direction currentDirection;
     Direction nextDirection;
     bool gameOver;
     int score;
+    std::uint32_t tick;
+    CellChangeList cellChanges;
+    
+    // Moving hands the queues over and leaves the source with none
+    struct Subscribers {
+        std::array<GameEventQueue*, MAX_EVENT_SUBSCRIBERS> queues{};
+        int count = 0;
+        
+        Subscribers() = default;
+        Subscribers(Subscribers&& other) noexcept : queues(other.queues), count(other.count) {
+            other.count = 0;
+        }
+        Subscribers& operator=(Subscribers&& other) noexcept {
+            queues = other.queues;
+            count = other.count;
+            other.count = 0;
+            return *this;
+        }
+    };
+    
+    Subscribers subscribers;
     
-    std::mt19937 rng;
+    GameRng rng;
     std::uniform_int_distribution<int> xDist;
     std::uniform_int_distribution<int> yDist;
     
-    void generateFood();
-    bool isFoodOnSnake() const;
+    void trackBodyCapacity();
+    bool generateFood();
+    bool placeFoodInArea(int left, int top, int right, int bottom);
+    bool isFoodSpot(const Position& pos) const;
+    void publish(GameEvent::Type type, bool tailRemoved = false, const Position& tail = Position());
+    bool isFoodSpotOnLevel(const Position& pos) const;
     void moveSnake();
     bool checkCollision() const;
     Position getNextHeadPosition() const;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Storage is inline, so pushing and popping never allocate.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+    
+public:
+    // Producer side - returns false and counts a drop when the queue is full
+    bool tryPush(const T& item) {
+        size_t write = writeIndex.load(std::memory_order_relaxed);
+        if (write - cachedReadIndex == Capacity) {
+            cachedReadIndex = readIndex.load(std::memory_order_acquire);
+            if (write - cachedReadIndex == Capacity) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        
+        buffer[write & (Capacity - 1)] = item;
+        writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer side
+    bool tryPop(T& item) {
+        size_t read = readIndex.load(std::memory_order_relaxed);
+        if (read == cachedWriteIndex) {
+            cachedWriteIndex = writeIndex.load(std::memory_order_acquire);
+            if (read == cachedWriteIndex) {
+                return false;
+            }
+        }
+        
+        item = buffer[read & (Capacity - 1)];
+        readIndex.store(read + 1, std::memory_order_release);
+        return true;
+    }
+    
+    size_t size() const {
+        return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+    }
+    
+    size_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+    static constexpr size_t capacity() { return Capacity; }
+    
+private:
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    size_t cachedReadIndex = 0;
+    std::atomic<size_t> dropped{0};
+    
+    alignas(64) std::atomic<size_t> readIndex{0};
+    size_t cachedWriteIndex = 0;
+    
+    alignas(64) T buffer[Capacity];
+};
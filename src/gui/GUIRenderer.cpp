@@ -1,18 +1,30 @@
 #include "GUIRenderer.h"
+#include "../game/Level.h"
 #include <iostream>
 #include <sstream>
 
 GUIRenderer::GUIRenderer() 
 #ifdef ENABLE_GUI
     : scoreText()
+    , statusText()
     , gameOverText()
     , quit(false)
     , initialized(false)
     , lastDirection(Direction::RIGHT)
+    , boardOffsetX(0)
+    , boardOffsetY(0)
+    , boardWidth(0)
+    , renderedTick(0)
+    , repaintPending(true)
 #else
     : quit(false)
     , initialized(false)
     , lastDirection(Direction::RIGHT)
+    , boardOffsetX(0)
+    , boardOffsetY(0)
+    , boardWidth(0)
+    , renderedTick(0)
+    , repaintPending(true)
 #endif
 {
 }
@@ -64,18 +76,22 @@ bool GUIRenderer::initialize() {
     scoreText.setFillColor(sf::Color::White);
     scoreText.setPosition(sf::Vector2f(10, 10));
     
+    statusText.setFont(font);
+    statusText.setCharacterSize(16);
+    statusText.setFillColor(sf::Color::White);
+    statusText.setPosition(sf::Vector2f(10, 40));
+    
     gameOverText.setFont(font);
     gameOverText.setCharacterSize(36);
     gameOverText.setFillColor(sf::Color::Red);
     gameOverText.setPosition(sf::Vector2f(WINDOW_WIDTH/2 - 100, WINDOW_HEIGHT/2 - 50));
     
     // Setup shapes
-    snakeSegment.setSize(sf::Vector2f(CELL_SIZE - 1, CELL_SIZE - 1));
-    snakeSegment.setFillColor(sf::Color::Green);
-    
     foodShape.setRadius(CELL_SIZE / 2 - 1);
     foodShape.setFillColor(sf::Color::Red);
     
+    boardCells.setPrimitiveType(sf::PrimitiveType::Triangles);
+    
     initialized = true;
     return true;
 #else
@@ -90,10 +106,22 @@ void GUIRenderer::render(const SnakeGame& game) {
         return;
     }
     
+    // Only the cells touched by the last tick are recolored, anything else
+    // (first frame, reset, skipped ticks) rebuilds the whole board
+    const CellChangeList& changes = game.getCellChanges();
+    std::uint32_t tick = game.getTick();
+    if (repaintPending || changes.fullRepaint || (tick != renderedTick && tick != renderedTick + 1)) {
+        rebuildBoard(game);
+        repaintPending = false;
+    } else if (tick != renderedTick) {
+        applyCellChanges(game, changes);
+    }
+    renderedTick = tick;
+    
     window.clear(sf::Color::Black);
     
     // Draw game elements
-    drawSnake(game.getSnakeBody());
+    window.draw(boardCells);
     drawFood(game.getFoodPosition());
     drawScore(game.getScore());
     
@@ -150,20 +178,30 @@ void GUIRenderer::pollEvents() {
             switch (keyPressed->code) {
                 case sf::Keyboard::Key::Up:
                     lastDirection = Direction::UP;
+                    recordKeyPress('w');
                     break;
                 case sf::Keyboard::Key::Down:
                     lastDirection = Direction::DOWN;
+                    recordKeyPress('s');
                     break;
                 case sf::Keyboard::Key::Left:
                     lastDirection = Direction::LEFT;
+                    recordKeyPress('a');
                     break;
                 case sf::Keyboard::Key::Right:
                     lastDirection = Direction::RIGHT;
+                    recordKeyPress('d');
+                    break;
+                case sf::Keyboard::Key::Space:
+                    recordKeyPress(' ');
                     break;
                 case sf::Keyboard::Key::Escape:
                     quit = true;
                     break;
                 default:
+                    if (keyPressed->code >= sf::Keyboard::Key::Num0 && keyPressed->code <= sf::Keyboard::Key::Num9) {
+                        recordKeyPress(static_cast<char>('0' + (static_cast<int>(keyPressed->code) - static_cast<int>(sf::Keyboard::Key::Num0))));
+                    }
                     break;
             }
         }
@@ -180,20 +218,30 @@ void GUIRenderer::pollEvents() {
             switch (event.key.code) {
                 case sf::Keyboard::Up:
                     lastDirection = Direction::UP;
+                    recordKeyPress('w');
                     break;
                 case sf::Keyboard::Down:
                     lastDirection = Direction::DOWN;
+                    recordKeyPress('s');
                     break;
                 case sf::Keyboard::Left:
                     lastDirection = Direction::LEFT;
+                    recordKeyPress('a');
                     break;
                 case sf::Keyboard::Right:
                     lastDirection = Direction::RIGHT;
+                    recordKeyPress('d');
+                    break;
+                case sf::Keyboard::Space:
+                    recordKeyPress(' ');
                     break;
                 case sf::Keyboard::Escape:
                     quit = true;
                     break;
                 default:
+                    if (event.key.code >= sf::Keyboard::Num0 && event.key.code <= sf::Keyboard::Num9) {
+                        recordKeyPress(static_cast<char>('0' + (static_cast<int>(event.key.code) - static_cast<int>(sf::Keyboard::Num0))));
+                    }
                     break;
             }
         }
@@ -202,17 +250,74 @@ void GUIRenderer::pollEvents() {
 #endif
 }
 
-void GUIRenderer::drawSnake(const std::vector<Position>& snake) {
+void GUIRenderer::rebuildBoard(const SnakeGame& game) {
 #ifdef ENABLE_GUI
-    if (!initialized) return;
+    // Center the board in the window
+    boardWidth = game.getBoardWidth();
+    boardOffsetX = (WINDOW_WIDTH - game.getBoardWidth() * CELL_SIZE) / 2;
+    boardOffsetY = (WINDOW_HEIGHT - game.getBoardHeight() * CELL_SIZE) / 2;
+    
+    boardCells.resize(static_cast<size_t>(game.getBoardWidth()) * game.getBoardHeight() * 6);
+    for (int y = 0; y < game.getBoardHeight(); ++y) {
+        for (int x = 0; x < game.getBoardWidth(); ++x) {
+            float left = static_cast<float>(x * CELL_SIZE + boardOffsetX);
+            float top = static_cast<float>(y * CELL_SIZE + boardOffsetY);
+            float right = left + CELL_SIZE - 1;
+            float bottom = top + CELL_SIZE - 1;
+            
+            sf::Vertex* quad = &boardCells[(static_cast<size_t>(y) * boardWidth + x) * 6];
+            quad[0].position = sf::Vector2f(left, top);
+            quad[1].position = sf::Vector2f(right, top);
+            quad[2].position = sf::Vector2f(left, bottom);
+            quad[3].position = sf::Vector2f(left, bottom);
+            quad[4].position = sf::Vector2f(right, top);
+            quad[5].position = sf::Vector2f(right, bottom);
+            
+            setCellContent(Position(x, y), game.getLevel(), CellContent::EMPTY);
+        }
+    }
     
-    for (const auto& segment : snake) {
-        snakeSegment.setPosition(sf::Vector2f(
-            segment.x * CELL_SIZE + (WINDOW_WIDTH - SnakeGame::BOARD_WIDTH * CELL_SIZE) / 2,
-            segment.y * CELL_SIZE + (WINDOW_HEIGHT - SnakeGame::BOARD_HEIGHT * CELL_SIZE) / 2
-        ));
-        window.draw(snakeSegment);
+    for (const auto& segment : game.getSnakeBody()) {
+        setCellContent(segment, game.getLevel(), CellContent::SNAKE);
     }
+#else
+    (void)game;
+#endif
+}
+
+void GUIRenderer::applyCellChanges(const SnakeGame& game, const CellChangeList& changes) {
+    for (int i = 0; i < changes.count; ++i) {
+        // Food is drawn as its own shape, so it leaves the cell empty underneath
+        CellContent content = changes.changes[i].after;
+        setCellContent(changes.changes[i].position, game.getLevel(),
+                       content == CellContent::FOOD ? CellContent::EMPTY : content);
+    }
+}
+
+void GUIRenderer::setCellContent(const Position& pos, const Level* level, CellContent content) {
+#ifdef ENABLE_GUI
+    if (pos.x < 0 || pos.y < 0 || pos.x >= boardWidth ||
+        static_cast<size_t>(pos.y) * boardWidth + pos.x >= boardCells.getVertexCount() / 6) {
+        return;
+    }
+    
+    sf::Color color = sf::Color::Transparent;
+    if (content == CellContent::SNAKE) {
+        color = sf::Color::Green;
+    } else if (level && level->isWall(pos)) {
+        color = sf::Color(128, 128, 128);
+    } else if (level && level->isPortal(pos)) {
+        color = sf::Color::Magenta;
+    }
+    
+    sf::Vertex* quad = &boardCells[(static_cast<size_t>(pos.y) * boardWidth + pos.x) * 6];
+    for (int i = 0; i < 6; ++i) {
+        quad[i].color = color;
+    }
+#else
+    (void)pos;
+    (void)level;
+    (void)content;
 #endif
 }
 
@@ -221,8 +326,8 @@ void GUIRenderer::drawFood(const Position& food) {
     if (!initialized) return;
     
     foodShape.setPosition(sf::Vector2f(
-        food.x * CELL_SIZE + (WINDOW_WIDTH - SnakeGame::BOARD_WIDTH * CELL_SIZE) / 2,
-        food.y * CELL_SIZE + (WINDOW_HEIGHT - SnakeGame::BOARD_HEIGHT * CELL_SIZE) / 2
+        food.x * CELL_SIZE + boardOffsetX,
+        food.y * CELL_SIZE + boardOffsetY
     ));
     window.draw(foodShape);
 #endif
@@ -236,5 +341,27 @@ void GUIRenderer::drawScore(int score) {
     oss << "Score: " << score;
     scoreText.setString(oss.str());
     window.draw(scoreText);
+    
+    if (!statusLine.empty()) {
+        statusText.setString(statusLine);
+        window.draw(statusText);
+    }
 #endif
+}
+
+bool GUIRenderer::takeKeyPress(char& key) {
+    if (pendingKeys.empty()) {
+        return false;
+    }
+    key = pendingKeys.front();
+    pendingKeys.erase(0, 1);
+    return true;
+}
+
+void GUIRenderer::recordKeyPress(char key) {
+    // Nobody drains the keys during normal play, so only keep the latest few
+    if (pendingKeys.size() >= MAX_PENDING_KEYS) {
+        pendingKeys.erase(0, 1);
+    }
+    pendingKeys.push_back(key);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../game/SnakeGame.h"
+#include <string>
 
 #ifdef ENABLE_GUI
 #include <SFML/Graphics.hpp>
@@ -27,20 +28,42 @@ public:
     bool isWindowOpen() const;
     void pollEvents();
     
+    // Keys pressed since the last call, arrows reported as w/a/s/d
+    bool takeKeyPress(char& key);
+    
+    // Extra line under the score, used by replay playback
+    void setStatusText(const std::string& text) { statusLine = text; }
+    
+    // Rebuild the board on the next render, e.g. after the game jumped in time
+    void requestRepaint() { repaintPending = true; }
+    
 private:
 #ifdef ENABLE_GUI
     sf::RenderWindow window;
     sf::Font font;
     sf::Text scoreText;
+    sf::Text statusText;
     sf::Text gameOverText;
-    sf::RectangleShape snakeSegment;
     sf::CircleShape foodShape;
+    sf::VertexArray boardCells;     // 6 vertices per cell, recolored as cells change
 #endif
     bool quit;
     bool initialized;
     Direction lastDirection;
+    int boardOffsetX;
+    int boardOffsetY;
+    int boardWidth;
+    std::uint32_t renderedTick;
+    bool repaintPending;
+    std::string statusLine;
+    std::string pendingKeys;
+    
+    static constexpr size_t MAX_PENDING_KEYS = 16;
     
-    void drawSnake(const std::vector<Position>& snake);
+    void rebuildBoard(const SnakeGame& game);
+    void applyCellChanges(const SnakeGame& game, const CellChangeList& changes);
+    void setCellContent(const Position& pos, const Level* level, CellContent content);
     void drawFood(const Position& food);
     void drawScore(int score);
+    void recordKeyPress(char key);
 };
\ No newline at end of file
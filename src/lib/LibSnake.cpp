@@ -0,0 +1,168 @@
+#include "libsnake.h"
+#include "../game/SnakeGame.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+struct snake_env {
+    std::vector<SnakeGame> games;
+    int width;
+    int height;
+};
+
+namespace {
+    constexpr int OBS_PLANES = 3;
+    
+    template <typename T>
+    void writeObservation(const SnakeGame& game, int width, int height, T* planes) {
+        size_t planeSize = static_cast<size_t>(width) * height;
+        std::fill(planes, planes + OBS_PLANES * planeSize, T(0));
+        
+        T* body = planes;
+        T* head = planes + planeSize;
+        T* food = planes + 2 * planeSize;
+        
+        const auto& snake = game.getSnakeBody();
+        for (size_t i = 1; i < snake.size(); ++i) {
+            body[static_cast<size_t>(snake[i].y) * width + snake[i].x] = T(1);
+        }
+        
+        // Finished games are reset before their observation is written, so the
+        // head is always on the board
+        const Position& front = snake.front();
+        head[static_cast<size_t>(front.y) * width + front.x] = T(1);
+        
+        const Position& pellet = game.getFoodPosition();
+        food[static_cast<size_t>(pellet.y) * width + pellet.x] = T(1);
+    }
+    
+    void writeObservations(const snake_env* env, snake_obs_type type, void* obs) {
+        size_t envCells = static_cast<size_t>(OBS_PLANES) * env->width * env->height;
+        for (size_t i = 0; i < env->games.size(); ++i) {
+            if (type == SNAKE_OBS_FLOAT32) {
+                writeObservation(env->games[i], env->width, env->height,
+                                 static_cast<float*>(obs) + i * envCells);
+            } else {
+                writeObservation(env->games[i], env->width, env->height,
+                                 static_cast<std::uint8_t*>(obs) + i * envCells);
+            }
+        }
+    }
+    
+    bool isValidObsType(snake_obs_type type) {
+        return type == SNAKE_OBS_UINT8 || type == SNAKE_OBS_FLOAT32;
+    }
+}
+
+int snake_api_version(void) {
+    return SNAKE_API_VERSION;
+}
+
+snake_env* snake_env_create(int num_envs, int board_width, int board_height, uint64_t seed) {
+    if (num_envs <= 0 || board_width < 4 || board_height < 2 ||
+        board_width > SNAKE_MAX_BOARD_SIZE || board_height > SNAKE_MAX_BOARD_SIZE) {
+        return nullptr;
+    }
+    
+    try {
+        std::unique_ptr<snake_env> env(new snake_env);
+        env->width = board_width;
+        env->height = board_height;
+        env->games.reserve(static_cast<size_t>(num_envs));
+        
+        for (int i = 0; i < num_envs; ++i) {
+            env->games.emplace_back(board_width, board_height);
+            // Derive distinct but reproducible streams for every env
+            env->games.back().setSeed(static_cast<std::uint32_t>(seed * 0x9E3779B97F4A7C15ull + i));
+            env->games.back().reset();
+        }
+        return env.release();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void snake_env_destroy(snake_env* env) {
+    delete env;
+}
+
+int snake_env_num_envs(const snake_env* env) {
+    return env ? static_cast<int>(env->games.size()) : 0;
+}
+
+int snake_env_board_width(const snake_env* env) {
+    return env ? env->width : 0;
+}
+
+int snake_env_board_height(const snake_env* env) {
+    return env ? env->height : 0;
+}
+
+size_t snake_env_obs_bytes(const snake_env* env, snake_obs_type type) {
+    if (!env || !isValidObsType(type)) {
+        return 0;
+    }
+    size_t elementSize = type == SNAKE_OBS_FLOAT32 ? sizeof(float) : sizeof(std::uint8_t);
+    return env->games.size() * OBS_PLANES * env->width * env->height * elementSize;
+}
+
+int snake_env_reset(snake_env* env, snake_obs_type type, void* obs) {
+    if (!env || (obs && !isValidObsType(type))) {
+        return SNAKE_ERROR_INVALID_ARGUMENT;
+    }
+    
+    try {
+        for (auto& game : env->games) {
+            game.reset();
+        }
+        if (obs) {
+            writeObservations(env, type, obs);
+        }
+        return SNAKE_OK;
+    } catch (...) {
+        return SNAKE_ERROR_INTERNAL;
+    }
+}
+
+int snake_env_step(snake_env* env, const int32_t* actions,
+                   snake_obs_type type, void* obs,
+                   float* rewards, uint8_t* dones) {
+    if (!env || !actions || !rewards || !dones || (obs && !isValidObsType(type))) {
+        return SNAKE_ERROR_INVALID_ARGUMENT;
+    }
+    
+    size_t count = env->games.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (actions[i] < 0 || actions[i] > 3) {
+            return SNAKE_ERROR_INVALID_ARGUMENT;
+        }
+    }
+    
+    try {
+        for (size_t i = 0; i < count; ++i) {
+            SnakeGame& game = env->games[i];
+            
+            // Action values follow the Direction enum order
+            game.setDirection(static_cast<Direction>(actions[i]));
+            
+            int scoreBefore = game.getScore();
+            bool alive = game.update();
+            bool ate = game.getScore() != scoreBefore;
+            
+            // Filling the whole board also ends the game, but as a win
+            rewards[i] = ate ? 1.0f : (alive ? 0.0f : -1.0f);
+            dones[i] = alive ? 0 : 1;
+            
+            if (!alive) {
+                game.reset();
+            }
+        }
+        
+        if (obs) {
+            writeObservations(env, type, obs);
+        }
+        return SNAKE_OK;
+    } catch (...) {
+        return SNAKE_ERROR_INTERNAL;
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * libsnake - batched Snake environments for reinforcement learning.
+ *
+ * A snake_env owns N independent games that are reset and stepped together.
+ * Every output is written into buffers supplied by the caller, and stepping
+ * does not allocate once the environments are warmed up.
+ *
+ * Observation layout (per call): [num_envs][3][height][width]
+ *   plane 0 - snake body (excluding the head)
+ *   plane 1 - snake head
+ *   plane 2 - food
+ * Cells are 1 when set and 0 otherwise, as uint8 or float32.
+ *
+ * Actions: 0 = up, 1 = down, 2 = left, 3 = right. Reversing is ignored.
+ * Rewards: +1 for eating, -1 for dying, 0 otherwise.
+ * A game that finishes is reset automatically; the observation written for
+ * that env is the first state of the new game and its done flag is 1.
+ */
+#ifndef LIBSNAKE_H
+#define LIBSNAKE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #if defined(LIBSNAKE_BUILD)
+        #define SNAKE_API __declspec(dllexport)
+    #else
+        #define SNAKE_API __declspec(dllimport)
+    #endif
+#else
+    #define SNAKE_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SNAKE_API_VERSION 1
+
+#define SNAKE_OK 0
+#define SNAKE_ERROR_INVALID_ARGUMENT -1
+#define SNAKE_ERROR_INTERNAL -2
+
+/* Largest supported board side; each env reserves width * height * 8 bytes */
+#define SNAKE_MAX_BOARD_SIZE 1024
+
+typedef enum snake_obs_type {
+    SNAKE_OBS_UINT8 = 0,
+    SNAKE_OBS_FLOAT32 = 1
+} snake_obs_type;
+
+typedef struct snake_env snake_env;
+
+SNAKE_API int snake_api_version(void);
+
+/* Returns NULL if the arguments are invalid (board must be at least 4x2 and at
+   most SNAKE_MAX_BOARD_SIZE on each side) or allocation fails */
+SNAKE_API snake_env* snake_env_create(int num_envs, int board_width, int board_height, uint64_t seed);
+SNAKE_API void snake_env_destroy(snake_env* env);
+
+SNAKE_API int snake_env_num_envs(const snake_env* env);
+SNAKE_API int snake_env_board_width(const snake_env* env);
+SNAKE_API int snake_env_board_height(const snake_env* env);
+
+/* Bytes needed for the observations of all envs in one call */
+SNAKE_API size_t snake_env_obs_bytes(const snake_env* env, snake_obs_type type);
+
+/* obs may be NULL to skip writing observations */
+SNAKE_API int snake_env_reset(snake_env* env, snake_obs_type type, void* obs);
+
+/* actions, rewards and dones hold num_envs entries; obs may be NULL */
+SNAKE_API int snake_env_step(snake_env* env, const int32_t* actions,
+                             snake_obs_type type, void* obs,
+                             float* rewards, uint8_t* dones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBSNAKE_H */
@@ -1,9 +1,14 @@
+#include <algorithm>
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <memory>
+#include <sstream>
+#include <string>
 
 #include "game/SnakeGame.h"
+#include "game/Level.h"
+#include "game/Replay.h"
 #include "cli/CLIRenderer.h"
 #include "gui/GUIRenderer.h"
 
@@ -13,15 +18,16 @@ void showMainMenu() {
     std::cout << "================================\n";
     std::cout << "[1] Play in Terminal (CLI)\n";
     std::cout << "[2] Play with Graphics (GUI)\n";
-    std::cout << "[3] Quit\n";
-    std::cout << "Enter choice (1-3): ";
+    std::cout << "[3] Play Endless World (CLI)\n";
+    std::cout << "[4] Quit\n";
+    std::cout << "Enter choice (1-4): ";
 }
 
 int getMenuChoice() {
     int choice;
     if (std::cin >> choice) {
         std::cin.ignore(10000, '\n'); // Clear the rest of the line
-        if (choice >= 1 && choice <= 3) {
+        if (choice >= 1 && choice <= 4) {
             return choice;
         }
     } else {
@@ -32,29 +38,63 @@ int getMenuChoice() {
     return -1;
 }
 
-void runCLIMode() {
+// Drains pending game events, returns true once the snake has died
+bool drainEvents(GameEventQueue& events, int& finalScore) {
+    bool died = false;
+    GameEvent event;
+    while (events.tryPop(event)) {
+        if (event.type == GameEvent::Type::DIED) {
+            finalScore = event.score;
+            died = true;
+        }
+    }
+    return died;
+}
+
+// recordPath is cleared once a game is being recorded, so only that one game
+// is saved and later games in the session do not overwrite it
+void runCLIMode(GameMode mode, const Level* level, std::string& recordPath) {
     std::cout << "Starting CLI mode...\n";
     std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     
-    SnakeGame game;
+    SnakeGame game = level ? SnakeGame(*level) : SnakeGame(mode);
+    
+    ReplayWriter replay;
+    if (!recordPath.empty() && replay.open(recordPath, game)) {
+        recordPath.clear();
+    }
+    
     CLIRenderer renderer;
     
+    GameEventQueue events;
+    game.subscribe(events);
+    
     renderer.clear();
     
     auto lastUpdate = std::chrono::steady_clock::now();
     const auto updateInterval = std::chrono::milliseconds(100); // 10 FPS
     
     bool quit = false;
+    bool died = false;
+    int finalScore = 0;
     
-    while (!quit && !game.isGameOver()) {
+    while (!quit && !died) {
         auto now = std::chrono::steady_clock::now();
         
         // Handle input
         if (renderer.hasInput()) {
             char input = renderer.getInput();
-            if (input == 'q' || input == 'Q' || input == 27) { // 'q' or ESC
+            bool arrow;
+            Direction arrowDirection;
+            if (renderer.readExtendedKey(input, arrow, arrowDirection)) {
+                if (arrow) {
+                    game.setDirection(arrowDirection);
+                }
+            } else if (input == 'q' || input == 'Q' || input == 27) { // 'q' or ESC
                 quit = true;
                 break;
+            } else if (input == 'h' || input == 'H') {
+                renderer.setHalfBlockMode(!renderer.isHalfBlockMode());
             } else {
                 Direction dir = renderer.getDirectionFromInput(input);
                 game.setDirection(dir);
@@ -64,7 +104,9 @@ void runCLIMode() {
         // Update game at fixed intervals
         if (now - lastUpdate >= updateInterval) {
             game.update();
+            replay.recordTick(game);
             renderer.render(game);
+            died = drainEvents(events, finalScore);
             lastUpdate = now;
         }
         
@@ -72,15 +114,15 @@ void runCLIMode() {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     
-    if (game.isGameOver()) {
-        renderer.showGameOver(game.getScore());
+    if (died) {
+        renderer.showGameOver(finalScore);
         std::cin.get(); // Wait for any key
     }
     
     renderer.clear();
 }
 
-void runGUIMode() {
+void runGUIMode(const Level* level, std::string& recordPath) {
     std::cout << "Starting GUI mode...\n";
     
     GUIRenderer renderer;
@@ -92,7 +134,17 @@ void runGUIMode() {
         return;
     }
     
-    SnakeGame game;
+    SnakeGame game = level ? SnakeGame(*level) : SnakeGame();
+    
+    ReplayWriter replay;
+    if (!recordPath.empty() && replay.open(recordPath, game)) {
+        recordPath.clear();
+    }
+    
+    GameEventQueue events;
+    game.subscribe(events);
+    bool died = false;
+    int finalScore = 0;
     
     auto lastUpdate = std::chrono::steady_clock::now();
     const auto updateInterval = std::chrono::milliseconds(150); // ~6.7 FPS for gameplay
@@ -118,16 +170,18 @@ void runGUIMode() {
         
         // Update game at fixed intervals
         if (now - lastUpdate >= updateInterval) {
-            if (!game.isGameOver()) {
+            if (!died) {
                 game.update();
+                replay.recordTick(game);
+                died = drainEvents(events, finalScore);
             }
             
             renderer.render(game);
             lastUpdate = now;
         }
         
-        if (game.isGameOver()) {
-            renderer.showGameOver(game.getScore());
+        if (died) {
+            renderer.showGameOver(finalScore);
             
             // Wait for ESC key to exit
             while (renderer.isWindowOpen() && !renderer.shouldQuit()) {
@@ -142,9 +196,256 @@ void runGUIMode() {
     }
 }
 
-int main() {
+// Replay position and speed, shared by the terminal and window viewers
+struct PlaybackControl {
+    static constexpr std::uint32_t SEEK_TICKS = 100;   // per Left/Right press, in game ticks
+    static constexpr int MAX_SPEED = 256;
+    
+    int speed = 1;
+    bool paused = false;
+    double pendingTicks = 0.0;
+};
+
+SnakeGame createReplayGame(const ReplayReader& replay) {
+    return replay.getMode() == GameMode::ENDLESS ? SnakeGame(GameMode::ENDLESS)
+                                                 : SnakeGame(replay.getBoardWidth(), replay.getBoardHeight());
+}
+
+// Arrow keys drive playback through the same bindings as w/a/s/d
+char playbackKeyFor(Direction arrow) {
+    switch (arrow) {
+        case Direction::UP:    return 'w';
+        case Direction::DOWN:  return 's';
+        case Direction::LEFT:  return 'a';
+        case Direction::RIGHT: return 'd';
+    }
+    return 'w';
+}
+
+// Applies a playback key (arrows as w/a/s/d), returns true if the game jumped
+bool handlePlaybackKey(char key, ReplayReader& replay, SnakeGame& game, PlaybackControl& control) {
+    std::uint32_t tick = game.getTick();
+    std::uint32_t target;
+    
+    switch (key) {
+        case ' ':
+            control.paused = !control.paused;
+            return false;
+        case 'w': case 'W':
+            control.speed = std::min(PlaybackControl::MAX_SPEED, control.speed * 2);
+            return false;
+        case 's': case 'S':
+            control.speed = std::max(1, control.speed / 2);
+            return false;
+        case 'd': case 'D':
+            target = tick + PlaybackControl::SEEK_TICKS;
+            break;
+        case 'a': case 'A':
+            target = tick > PlaybackControl::SEEK_TICKS ? tick - PlaybackControl::SEEK_TICKS : 0;
+            break;
+        default:
+            if (key < '0' || key > '9') {
+                return false;
+            }
+            target = static_cast<std::uint32_t>(static_cast<std::uint64_t>(replay.getTickCount()) * (key - '0') / 10);
+            break;
+    }
+    
+    control.pendingTicks = 0.0;
+    return replay.seek(game, target);
+}
+
+// Plays the ticks that fall into elapsed at the current speed
+bool advancePlayback(const ReplayReader& replay, SnakeGame& game, PlaybackControl& control,
+                     std::chrono::steady_clock::duration elapsed, std::chrono::milliseconds tickInterval) {
+    if (control.paused) {
+        return false;
+    }
+    
+    control.pendingTicks += std::chrono::duration<double>(elapsed) / tickInterval * control.speed;
+    bool advanced = false;
+    while (control.pendingTicks >= 1.0) {
+        if (!replay.step(game)) {
+            control.pendingTicks = 0.0;
+            break;
+        }
+        control.pendingTicks -= 1.0;
+        advanced = true;
+    }
+    return advanced;
+}
+
+std::string playbackStatus(const ReplayReader& replay, const SnakeGame& game, const PlaybackControl& control) {
+    std::ostringstream status;
+    status << "Replay " << game.getTick() << "/" << replay.getTickCount() << " x" << control.speed;
+    if (control.paused) {
+        status << " paused";
+    } else if (game.getTick() == replay.getTickCount()) {
+        status << " end";
+    }
+    status << " | Space pause | Left/Right seek | Up/Down speed | 0-9 jump | Q quit";
+    return status.str();
+}
+
+void runCLIReplay(ReplayReader& replay) {
+    SnakeGame game = createReplayGame(replay);
+    replay.seek(game, 0);
+    
+    CLIRenderer renderer;
+    renderer.clear();
+    
+    PlaybackControl control;
+    const auto tickInterval = std::chrono::milliseconds(100); // same pace as CLI play
+    auto lastFrame = std::chrono::steady_clock::now();
+    bool dirty = true;
+    bool quit = false;
+    
+    while (!quit) {
+        auto now = std::chrono::steady_clock::now();
+        
+        while (renderer.hasInput()) {
+            char input = renderer.getInput();
+            char key = input;
+            bool arrow;
+            Direction arrowDirection;
+            if (renderer.readExtendedKey(input, arrow, arrowDirection)) {
+                if (!arrow) {
+                    continue;
+                }
+                key = playbackKeyFor(arrowDirection);
+            } else if (input == 27) {
+                // A lone ESC quits, anything after it is a key sequence and
+                // only the arrows mean something during playback
+                if (!renderer.hasInput()) {
+                    quit = true;
+                    break;
+                }
+                if (!renderer.readArrowSequence(arrowDirection)) {
+                    continue;
+                }
+                key = playbackKeyFor(arrowDirection);
+            } else if (input == 'q' || input == 'Q') {
+                quit = true;
+                break;
+            } else if (input == 'h' || input == 'H') {
+                renderer.setHalfBlockMode(!renderer.isHalfBlockMode());
+                dirty = true;
+                continue;
+            }
+            
+            if (handlePlaybackKey(key, replay, game, control)) {
+                renderer.requestRepaint();
+            }
+            dirty = true;
+        }
+        
+        dirty |= advancePlayback(replay, game, control, now - lastFrame, tickInterval);
+        lastFrame = now;
+        
+        if (dirty && !quit) {
+            renderer.setStatusText(playbackStatus(replay, game, control));
+            renderer.render(game);
+            dirty = false;
+        }
+        
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    
+    renderer.clear();
+}
+
+void runGUIReplay(ReplayReader& replay) {
+    GUIRenderer renderer;
+    
+    if (!renderer.initialize()) {
+        std::cout << "Failed to initialize GUI mode. SFML might not be available.\n";
+        return;
+    }
+    
+    SnakeGame game = createReplayGame(replay);
+    replay.seek(game, 0);
+    
+    PlaybackControl control;
+    const auto tickInterval = std::chrono::milliseconds(150); // same pace as GUI play
+    auto lastFrame = std::chrono::steady_clock::now();
+    
+    while (renderer.isWindowOpen() && !renderer.shouldQuit()) {
+        auto now = std::chrono::steady_clock::now();
+        
+        renderer.pollEvents();
+        if (renderer.shouldQuit()) {
+            break;
+        }
+        
+        char key;
+        while (renderer.takeKeyPress(key)) {
+            if (handlePlaybackKey(key, replay, game, control)) {
+                renderer.requestRepaint();
+            }
+        }
+        
+        advancePlayback(replay, game, control, now - lastFrame, tickInterval);
+        lastFrame = now;
+        
+        renderer.setStatusText(playbackStatus(replay, game, control));
+        renderer.render(game);
+        
+        std::this_thread::sleep_for(std::chrono::milliseconds(16)); // ~60 FPS for rendering
+    }
+}
+
+int main(int argc, char* argv[]) {
     std::cout << "Welcome to the Snake Game!\n\n";
     
+    // snake-game [level.snl] [--record replay.snr] [--replay replay.snr [--gui]]
+    std::string levelPath;
+    std::string recordPath;
+    std::string replayPath;
+    bool replayInWindow = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--gui") {
+            replayInWindow = true;
+        } else if (arg.compare(0, 2, "--") == 0 || !levelPath.empty()) {
+            std::cerr << "Usage: snake-game [level.snl] [--record replay.snr] [--replay replay.snr [--gui]]\n";
+            return 1;
+        } else {
+            levelPath = arg;
+        }
+    }
+    
+    if (!replayPath.empty()) {
+        ReplayReader replay;
+        if (!replay.load(replayPath)) {
+            return 1;
+        }
+        if (replayInWindow) {
+            // The window draws the whole board, which an endless world cannot fit
+            if (replay.getMode() == GameMode::ENDLESS) {
+                std::cerr << "Endless replays can only be watched in the terminal (drop --gui)\n";
+                return 1;
+            }
+            runGUIReplay(replay);
+        } else {
+            runCLIReplay(replay);
+        }
+        return 0;
+    }
+    
+    // Optional compiled level file, used by the classic CLI and GUI modes
+    Level level;
+    if (!levelPath.empty()) {
+        if (!level.load(levelPath)) {
+            return 1;
+        }
+        std::cout << "Loaded level " << levelPath << " (" << level.getWidth() << "x" << level.getHeight() << ")\n\n";
+    }
+    const Level* activeLevel = level.isLoaded() ? &level : nullptr;
+    
     while (true) {
         showMainMenu();
         
@@ -152,19 +453,23 @@ int main() {
         
         switch (choice) {
             case 1:
-                runCLIMode();
+                runCLIMode(GameMode::CLASSIC, activeLevel, recordPath);
                 break;
                 
             case 2:
-                runGUIMode();
+                runGUIMode(activeLevel, recordPath);
                 break;
                 
             case 3:
+                runCLIMode(GameMode::ENDLESS, nullptr, recordPath);
+                break;
+                
+            case 4:
                 std::cout << "Thanks for playing! Goodbye!\n";
                 return 0;
                 
             default:
-                std::cout << "Invalid choice. Please enter 1, 2, or 3.\n\n";
+                std::cout << "Invalid choice. Please enter 1, 2, 3, or 4.\n\n";
                 break;
         }
         
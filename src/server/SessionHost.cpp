@@ -0,0 +1,98 @@
+// Hosts many paced bot sessions on a SessionScheduler and reports how late
+// their ticks ran. Usage: snake-session-host [sessions] [threads] [seconds] [tick-ms]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "SessionScheduler.h"
+#include "../game/SnakeGame.h"
+
+namespace {
+
+struct LatenessStats {
+    std::atomic<long long> ticks{0};
+    std::atomic<long long> totalMicros{0};
+    std::atomic<long long> maxMicros{0};
+    std::atomic<long long> bodyAllocations{0};
+    std::atomic<long long> bodyPeakBytes{0};
+    
+    void record(long long micros) {
+        ticks.fetch_add(1, std::memory_order_relaxed);
+        totalMicros.fetch_add(micros, std::memory_order_relaxed);
+        long long seen = maxMicros.load(std::memory_order_relaxed);
+        while (micros > seen && !maxMicros.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+// Greedy bot: head for the food, preferring moves that are not blocked
+Direction chooseDirection(const SnakeGame& game) {
+    const Position& head = game.getSnakeBody().front();
+    const Position& food = game.getFoodPosition();
+    
+    if (food.x > head.x && game.getCurrentDirection() != Direction::LEFT) return Direction::RIGHT;
+    if (food.x < head.x && game.getCurrentDirection() != Direction::RIGHT) return Direction::LEFT;
+    if (food.y > head.y && game.getCurrentDirection() != Direction::UP) return Direction::DOWN;
+    if (food.y < head.y && game.getCurrentDirection() != Direction::DOWN) return Direction::UP;
+    return game.getCurrentDirection();
+}
+
+Session botSession(SessionScheduler::Clock::duration interval,
+                   SessionScheduler::Clock::time_point end, LatenessStats& stats) {
+    SnakeGame game;
+    auto next = SessionScheduler::Clock::now();
+    
+    while (next + interval < end) {
+        next += interval;
+        co_await SessionScheduler::sleepUntil(next);
+        
+        auto late = std::chrono::duration_cast<std::chrono::microseconds>(SessionScheduler::Clock::now() - next);
+        stats.record(late.count());
+        
+        game.setDirection(chooseDirection(game));
+        if (!game.update()) {
+            game.reset();
+        }
+    }
+    
+    stats.bodyAllocations.fetch_add(game.getBodyStats().allocations, std::memory_order_relaxed);
+    stats.bodyPeakBytes.fetch_add(game.getBodyStats().peakBytes, std::memory_order_relaxed);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int sessions = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 1;
+    int seconds = argc > 3 ? std::atoi(argv[3]) : 5;
+    int tickMs = argc > 4 ? std::atoi(argv[4]) : 100;
+    
+    if (sessions <= 0 || threads <= 0 || seconds <= 0 || tickMs <= 0) {
+        std::cerr << "Usage: snake-session-host [sessions] [threads] [seconds] [tick-ms]\n";
+        return 1;
+    }
+    
+    LatenessStats stats;
+    SessionScheduler scheduler(static_cast<unsigned>(threads));
+    
+    auto end = SessionScheduler::Clock::now() + std::chrono::seconds(seconds);
+    for (int i = 0; i < sessions; ++i) {
+        // Spread the tick rates a little so sessions do not all wake together
+        auto interval = std::chrono::milliseconds(tickMs) + std::chrono::microseconds((i % 10) * 1000);
+        scheduler.spawn(botSession(interval, end, stats));
+    }
+    
+    scheduler.waitUntilIdle();
+    
+    long long ticks = stats.ticks.load();
+    std::cout << "Sessions: " << sessions << " on " << threads << " thread(s)\n";
+    std::cout << "Ticks: " << ticks << " (" << ticks / seconds << "/s)\n";
+    std::cout << "Lateness: mean " << (ticks ? stats.totalMicros.load() / ticks : 0)
+              << " us, max " << stats.maxMicros.load() << " us\n";
+    std::cout << "Body buffers: " << stats.bodyAllocations.load() << " allocation(s), "
+              << stats.bodyPeakBytes.load() / sessions << " bytes peak per session\n";
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include "SessionScheduler.h"
+#include <algorithm>
+#include <iostream>
+
+thread_local SessionScheduler::Worker* SessionScheduler::currentWorker = nullptr;
+
+std::suspend_never Session::promise_type::final_suspend() noexcept {
+    scheduler->sessionFinished();
+    return {};
+}
+
+void Session::promise_type::unhandled_exception() {
+    std::cerr << "Session terminated by an unhandled exception\n";
+}
+
+void SessionScheduler::TickAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    Worker* worker = currentWorker;
+    node.expires = worker->tickFor(deadline);
+    node.handle = handle;
+    worker->wheel.insert(&node);
+}
+
+SessionScheduler::SessionScheduler(unsigned threadCount, Clock::duration resolution)
+    : resolution(resolution)
+    , running(true)
+    , activeSessions(0)
+    , nextWorker(0)
+{
+    Clock::time_point epoch = Clock::now();
+    threadCount = std::max(1u, threadCount);
+    
+    for (unsigned i = 0; i < threadCount; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->scheduler = this;
+        worker->epoch = epoch;
+        workers.push_back(std::move(worker));
+    }
+    
+    for (auto& worker : workers) {
+        worker->thread = std::thread(&Worker::run, worker.get());
+    }
+}
+
+SessionScheduler::~SessionScheduler() {
+    stop();
+}
+
+void SessionScheduler::spawn(Session session) {
+    auto handle = session.handle;
+    session.handle = nullptr;
+    handle.promise().scheduler = this;
+    activeSessions.fetch_add(1, std::memory_order_acq_rel);
+    
+    Worker& worker = *workers[nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.inboxMutex);
+        worker.inbox.push_back(handle);
+    }
+    worker.inboxReady.notify_one();
+}
+
+void SessionScheduler::waitUntilIdle() {
+    std::unique_lock<std::mutex> lock(idleMutex);
+    idle.wait(lock, [this] { return activeSessions.load(std::memory_order_acquire) == 0; });
+}
+
+void SessionScheduler::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    
+    for (auto& worker : workers) {
+        {
+            std::lock_guard<std::mutex> lock(worker->inboxMutex);
+        }
+        worker->inboxReady.notify_all();
+    }
+    
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        
+        // The timer node lives in the coroutine frame, so read next first
+        size_t destroyed = 0;
+        TimerNode* node = worker->wheel.takeAll();
+        while (node) {
+            TimerNode* next = node->next;
+            node->handle.destroy();
+            destroyed++;
+            node = next;
+        }
+        for (auto handle : worker->inbox) {
+            handle.destroy();
+            destroyed++;
+        }
+        worker->inbox.clear();
+        
+        if (destroyed > 0 && activeSessions.fetch_sub(destroyed, std::memory_order_acq_rel) == destroyed) {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            idle.notify_all();
+        }
+    }
+}
+
+void SessionScheduler::sessionFinished() {
+    if (activeSessions.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        idle.notify_all();
+    }
+}
+
+void SessionScheduler::Worker::run() {
+    currentWorker = this;
+    
+    while (scheduler->running.load(std::memory_order_acquire)) {
+        {
+            std::unique_lock<std::mutex> lock(inboxMutex);
+            if (wheel.empty()) {
+                // Nothing pending, sleep until a session arrives
+                inboxReady.wait(lock, [this] {
+                    return !inbox.empty() || !scheduler->running.load(std::memory_order_acquire);
+                });
+            } else {
+                Clock::time_point nextTick = epoch + scheduler->resolution * (wheel.getCurrentTick() + 1);
+                inboxReady.wait_until(lock, nextTick, [this] {
+                    return !inbox.empty() || !scheduler->running.load(std::memory_order_acquire);
+                });
+            }
+            spawning.swap(inbox);
+        }
+        
+        if (!scheduler->running.load(std::memory_order_acquire)) {
+            // Leave the adopted sessions for stop() to destroy
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            inbox.insert(inbox.end(), spawning.begin(), spawning.end());
+            spawning.clear();
+            break;
+        }
+        
+        // An idle wheel does not need to walk through the ticks it slept past
+        std::uint64_t dueTick = static_cast<std::uint64_t>((Clock::now() - epoch) / scheduler->resolution);
+        wheel.skipTo(dueTick);
+        
+        for (auto handle : spawning) {
+            handle.resume();
+        }
+        spawning.clear();
+        
+        while (wheel.getCurrentTick() < dueTick) {
+            TimerNode* node = wheel.advance();
+            while (node) {
+                // Resuming re-arms or destroys the frame holding this node
+                TimerNode* next = node->next;
+                node->handle.resume();
+                node = next;
+            }
+        }
+    }
+    
+    currentWorker = nullptr;
+}
+
+std::uint64_t SessionScheduler::Worker::tickFor(Clock::time_point time) const {
+    // Round up so a session is never woken before its deadline
+    auto elapsed = time - epoch;
+    if (elapsed <= Clock::duration::zero()) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>((elapsed + scheduler->resolution - Clock::duration(1)) / scheduler->resolution);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TimerWheel.h"
+
+class SessionScheduler;
+
+// Coroutine type for a paced session. Sessions start suspended, are handed to
+// SessionScheduler::spawn() and destroy themselves when they return.
+class Session {
+public:
+    struct promise_type {
+        SessionScheduler* scheduler = nullptr;
+        
+        Session get_return_object() {
+            return Session(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept;
+        void return_void() {}
+        void unhandled_exception();
+    };
+    
+    Session(Session&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+    Session& operator=(Session&&) = delete;
+    ~Session() {
+        if (handle) handle.destroy();
+    }
+    
+private:
+    friend class SessionScheduler;
+    explicit Session(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Runs thousands of sessions per thread. Every worker owns a timer wheel, and
+// a session only wakes up when its next tick is due.
+class SessionScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    // Awaitable returned by sleepUntil(), holds the wheel entry for the session
+    struct TickAwaiter {
+        Clock::time_point deadline;
+        TimerNode node;
+        
+        // Always suspend, so a session running behind cannot starve the others
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const {}
+    };
+    
+    explicit SessionScheduler(unsigned threadCount = 1,
+                              Clock::duration resolution = std::chrono::milliseconds(1));
+    ~SessionScheduler();
+    
+    SessionScheduler(const SessionScheduler&) = delete;
+    SessionScheduler& operator=(const SessionScheduler&) = delete;
+    
+    // Hands the session to a worker, which resumes it on its next loop
+    void spawn(Session session);
+    
+    // Suspends the calling session until the deadline. Only valid inside a
+    // session running on this scheduler.
+    static TickAwaiter sleepUntil(Clock::time_point deadline) { return TickAwaiter{ deadline, {} }; }
+    
+    size_t getActiveSessions() const { return activeSessions.load(std::memory_order_acquire); }
+    void waitUntilIdle();
+    
+    // Stops the workers and destroys any sessions that are still suspended
+    void stop();
+    
+private:
+    struct Worker {
+        SessionScheduler* scheduler = nullptr;
+        TimerWheel wheel;
+        Clock::time_point epoch;
+        
+        std::mutex inboxMutex;
+        std::condition_variable inboxReady;
+        std::vector<std::coroutine_handle<>> inbox;
+        std::vector<std::coroutine_handle<>> spawning;
+        
+        std::thread thread;
+        
+        void run();
+        std::uint64_t tickFor(Clock::time_point time) const;
+    };
+    
+    friend struct Session::promise_type;
+    void sessionFinished();
+    
+    static thread_local Worker* currentWorker;
+    
+    Clock::duration resolution;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running;
+    std::atomic<size_t> activeSessions;
+    std::atomic<size_t> nextWorker;
+    
+    std::mutex idleMutex;
+    std::condition_variable idle;
+};
@@ -0,0 +1,106 @@
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel()
+    : slots()
+    , ready(nullptr)
+    , currentTick(0)
+    , count(0)
+{
+}
+
+void TimerWheel::insert(TimerNode* node) {
+    count++;
+    place(node);
+}
+
+TimerNode* TimerWheel::advance() {
+    currentTick++;
+    
+    // Pull the next block of each upper level down whenever a lower level wraps
+    for (int level = 1; level < LEVELS; ++level) {
+        std::uint64_t lowerBits = currentTick & ((std::uint64_t(1) << (SLOT_BITS * level)) - 1);
+        if (lowerBits != 0) {
+            break;
+        }
+        cascade(level);
+    }
+    
+    TimerNode*& slot = slots[0][currentTick & (SLOTS - 1)];
+    TimerNode* expired = slot;
+    slot = nullptr;
+    
+    // Anything inserted as already due goes out with this tick
+    if (ready) {
+        TimerNode* tail = ready;
+        while (tail->next) tail = tail->next;
+        tail->next = expired;
+        expired = ready;
+        ready = nullptr;
+    }
+    
+    for (TimerNode* node = expired; node; node = node->next) {
+        count--;
+    }
+    return expired;
+}
+
+void TimerWheel::skipTo(std::uint64_t tick) {
+    if (count == 0 && tick > currentTick) {
+        currentTick = tick;
+    }
+}
+
+TimerNode* TimerWheel::takeAll() {
+    TimerNode* all = ready;
+    ready = nullptr;
+    for (auto& level : slots) {
+        for (auto& slot : level) {
+            while (slot) {
+                TimerNode* node = slot;
+                slot = node->next;
+                node->next = all;
+                all = node;
+            }
+        }
+    }
+    count = 0;
+    return all;
+}
+
+void TimerWheel::place(TimerNode* node) {
+    if (node->expires <= currentTick) {
+        node->next = ready;
+        ready = node;
+        return;
+    }
+    
+    std::uint64_t delta = node->expires - currentTick;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (std::uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    
+    // Timers beyond the top level's range wait in its furthest slot and get
+    // re-placed each time that slot cascades
+    std::uint64_t target = node->expires;
+    std::uint64_t maxDelta = (std::uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+    if (delta > maxDelta) {
+        target = currentTick + maxDelta;
+    }
+    
+    TimerNode*& slot = slots[level][(target >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    node->next = slot;
+    slot = node;
+}
+
+void TimerWheel::cascade(int level) {
+    TimerNode*& slot = slots[level][(currentTick >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    TimerNode* node = slot;
+    slot = nullptr;
+    
+    while (node) {
+        TimerNode* next = node->next;
+        place(node);
+        node = next;
+    }
+}
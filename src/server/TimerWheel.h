@@ -0,0 +1,50 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+// Intrusive timer entry. It lives inside the suspended coroutine's frame, so
+// arming a timer never allocates.
+struct TimerNode {
+    TimerNode* next = nullptr;
+    std::uint64_t expires = 0;
+    std::coroutine_handle<> handle;
+};
+
+// Hierarchical timing wheel: four levels of 256 slots. Insertion is O(1), and
+// each tick touches one level-0 slot plus an occasional cascade from above.
+// Not thread-safe - every scheduler worker owns its own wheel.
+class TimerWheel {
+public:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    
+    TimerWheel();
+    
+    std::uint64_t getCurrentTick() const { return currentTick; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    
+    // Timers at or before the current tick are appended to the ready list
+    void insert(TimerNode* node);
+    
+    // Moves to the next tick and returns the timers that expired on it
+    TimerNode* advance();
+    
+    // Jumps straight to a later tick, only valid while the wheel is empty
+    void skipTo(std::uint64_t tick);
+    
+    // Unlinks every pending timer, used when shutting down
+    TimerNode* takeAll();
+    
+private:
+    TimerNode* slots[LEVELS][SLOTS];
+    TimerNode* ready;
+    std::uint64_t currentTick;
+    size_t count;
+    
+    void place(TimerNode* node);
+    void cascade(int level);
+};
@@ -0,0 +1,292 @@
+// Offline level compiler: turns a text layout into a memory-mappable .snl file.
+//
+// Layout characters:
+//   '#'          wall
+//   '.' or ' '   floor
+//   '@'          spawn (snake head, body extends two cells to the left)
+//   'a' - 'z'    portals, each letter must appear exactly twice
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "../game/LevelFormat.h"
+
+using namespace LevelFormat;
+
+namespace {
+
+struct Cell {
+    int x, y;
+};
+
+struct Layout {
+    int width = 0;
+    int height = 0;
+    Cell spawn = { -1, -1 };
+    std::vector<bool> walls;
+    std::vector<LevelPortal> portals;
+    
+    bool isWall(int x, int y) const {
+        return x < 0 || x >= width || y < 0 || y >= height || walls[y * width + x];
+    }
+};
+
+bool parseLayout(std::istream& input, Layout& layout) {
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        lines.push_back(line);
+    }
+    while (!lines.empty() && lines.back().empty()) {
+        lines.pop_back();
+    }
+    
+    layout.height = static_cast<int>(lines.size());
+    for (const auto& row : lines) {
+        layout.width = std::max(layout.width, static_cast<int>(row.size()));
+    }
+    
+    if (layout.width == 0 || layout.height == 0 ||
+        layout.width > static_cast<int>(MAX_DIMENSION) || layout.height > static_cast<int>(MAX_DIMENSION)) {
+        std::cerr << "Layout must be between 1x1 and " << MAX_DIMENSION << "x" << MAX_DIMENSION << "\n";
+        return false;
+    }
+    
+    layout.walls.assign(static_cast<size_t>(layout.width) * layout.height, false);
+    std::map<char, std::vector<Cell>> portalCells;
+    
+    for (int y = 0; y < layout.height; ++y) {
+        for (int x = 0; x < static_cast<int>(lines[y].size()); ++x) {
+            char c = lines[y][x];
+            if (c == '#') {
+                layout.walls[y * layout.width + x] = true;
+            } else if (c == '@') {
+                if (layout.spawn.x >= 0) {
+                    std::cerr << "Layout has more than one spawn '@'\n";
+                    return false;
+                }
+                layout.spawn = { x, y };
+            } else if (c >= 'a' && c <= 'z') {
+                portalCells[c].push_back({ x, y });
+            } else if (c != '.' && c != ' ') {
+                std::cerr << "Unknown layout character '" << c << "' at " << x << "," << y << "\n";
+                return false;
+            }
+        }
+    }
+    
+    if (layout.spawn.x < 0) {
+        std::cerr << "Layout has no spawn '@'\n";
+        return false;
+    }
+    if (layout.isWall(layout.spawn.x - 1, layout.spawn.y) || layout.isWall(layout.spawn.x - 2, layout.spawn.y)) {
+        std::cerr << "Spawn needs two free cells to its left for the starting body\n";
+        return false;
+    }
+    
+    for (const auto& entry : portalCells) {
+        if (entry.second.size() != 2) {
+            std::cerr << "Portal '" << entry.first << "' must appear exactly twice\n";
+            return false;
+        }
+        const Cell& a = entry.second[0];
+        const Cell& b = entry.second[1];
+        layout.portals.push_back({ a.x, a.y, b.x, b.y });
+        layout.portals.push_back({ b.x, b.y, a.x, a.y });
+    }
+    
+    return true;
+}
+
+std::vector<std::uint8_t> buildWallMask(const Layout& layout) {
+    std::vector<std::uint8_t> mask((layout.walls.size() + 7) / 8, 0);
+    for (size_t i = 0; i < layout.walls.size(); ++i) {
+        if (layout.walls[i]) {
+            mask[i >> 3] |= static_cast<std::uint8_t>(1u << (i & 7));
+        }
+    }
+    return mask;
+}
+
+// Multi-source BFS seeded from every wall and from the area outside the board
+std::vector<std::uint16_t> buildWallDistance(const Layout& layout) {
+    std::vector<std::uint16_t> distance(layout.walls.size(), UNREACHABLE);
+    std::queue<Cell> frontier;
+    
+    for (int y = 0; y < layout.height; ++y) {
+        for (int x = 0; x < layout.width; ++x) {
+            if (layout.walls[y * layout.width + x]) {
+                distance[y * layout.width + x] = 0;
+                frontier.push({ x, y });
+            } else if (x == 0 || y == 0 || x == layout.width - 1 || y == layout.height - 1) {
+                distance[y * layout.width + x] = 1;
+                frontier.push({ x, y });
+            }
+        }
+    }
+    
+    const int dx[] = { 1, -1, 0, 0 };
+    const int dy[] = { 0, 0, 1, -1 };
+    while (!frontier.empty()) {
+        Cell cell = frontier.front();
+        frontier.pop();
+        std::uint16_t next = static_cast<std::uint16_t>(std::min<int>(distance[cell.y * layout.width + cell.x] + 1, UNREACHABLE - 1));
+        
+        for (int d = 0; d < 4; ++d) {
+            int x = cell.x + dx[d];
+            int y = cell.y + dy[d];
+            if (layout.isWall(x, y)) continue;
+            std::uint16_t& slot = distance[y * layout.width + x];
+            if (next < slot) {
+                slot = next;
+                frontier.push({ x, y });
+            }
+        }
+    }
+    
+    return distance;
+}
+
+// BFS over walkable cells from the spawn, stepping onto a portal lands on its partner
+std::vector<std::uint16_t> buildSpawnDistance(const Layout& layout) {
+    std::vector<std::uint16_t> distance(layout.walls.size(), UNREACHABLE);
+    std::vector<int> portalExit(layout.walls.size(), -1);
+    for (const auto& portal : layout.portals) {
+        portalExit[portal.fromY * layout.width + portal.fromX] = portal.toY * layout.width + portal.toX;
+    }
+    
+    std::queue<Cell> frontier;
+    distance[layout.spawn.y * layout.width + layout.spawn.x] = 0;
+    frontier.push(layout.spawn);
+    
+    const int dx[] = { 1, -1, 0, 0 };
+    const int dy[] = { 0, 0, 1, -1 };
+    while (!frontier.empty()) {
+        Cell cell = frontier.front();
+        frontier.pop();
+        std::uint16_t next = static_cast<std::uint16_t>(std::min<int>(distance[cell.y * layout.width + cell.x] + 1, UNREACHABLE - 1));
+        
+        for (int d = 0; d < 4; ++d) {
+            int x = cell.x + dx[d];
+            int y = cell.y + dy[d];
+            if (layout.isWall(x, y)) continue;
+            
+            int index = y * layout.width + x;
+            if (portalExit[index] >= 0) {
+                // The portal cell itself counts as reachable, the head lands on the exit
+                if (next < distance[index]) distance[index] = next;
+                index = portalExit[index];
+                x = index % layout.width;
+                y = index / layout.width;
+            }
+            if (next < distance[index]) {
+                distance[index] = next;
+                frontier.push({ x, y });
+            }
+        }
+    }
+    
+    return distance;
+}
+
+void appendSection(std::vector<LevelSection>& sections, std::vector<std::uint8_t>& payload,
+                   std::uint32_t type, const void* bytes, size_t size) {
+    while (payload.size() % 4 != 0) {
+        payload.push_back(0);
+    }
+    sections.push_back({ type, static_cast<std::uint32_t>(payload.size()), static_cast<std::uint32_t>(size), 0 });
+    const auto* begin = static_cast<const std::uint8_t*>(bytes);
+    payload.insert(payload.end(), begin, begin + size);
+}
+
+bool writeLevel(const Layout& layout, bool distanceFields, const std::string& path) {
+    std::vector<LevelSection> sections;
+    std::vector<std::uint8_t> payload;
+    
+    std::vector<std::uint8_t> wallMask = buildWallMask(layout);
+    appendSection(sections, payload, WALL_MASK, wallMask.data(), wallMask.size());
+    
+    if (!layout.portals.empty()) {
+        appendSection(sections, payload, PORTALS, layout.portals.data(),
+                      layout.portals.size() * sizeof(LevelPortal));
+    }
+    
+    if (distanceFields) {
+        std::vector<std::uint16_t> wallDistance = buildWallDistance(layout);
+        appendSection(sections, payload, WALL_DISTANCE, wallDistance.data(),
+                      wallDistance.size() * sizeof(std::uint16_t));
+        
+        std::vector<std::uint16_t> spawnDistance = buildSpawnDistance(layout);
+        appendSection(sections, payload, SPAWN_DISTANCE, spawnDistance.data(),
+                      spawnDistance.size() * sizeof(std::uint16_t));
+    }
+    
+    // Payload offsets were relative, rebase them past the header and section table
+    std::uint32_t base = static_cast<std::uint32_t>(sizeof(LevelHeader) + sections.size() * sizeof(LevelSection));
+    for (auto& section : sections) {
+        section.offset += base;
+    }
+    
+    LevelHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.width = static_cast<std::uint32_t>(layout.width);
+    header.height = static_cast<std::uint32_t>(layout.height);
+    header.spawnX = layout.spawn.x;
+    header.spawnY = layout.spawn.y;
+    header.sectionCount = static_cast<std::uint32_t>(sections.size());
+    header.reserved = 0;
+    
+    std::ofstream output(path, std::ios::binary);
+    if (!output) {
+        std::cerr << "Could not open output file: " << path << "\n";
+        return false;
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(LevelSection));
+    output.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    return static_cast<bool>(output);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    bool distanceFields = true;
+    
+    auto flag = std::find(args.begin(), args.end(), "--no-distance-fields");
+    if (flag != args.end()) {
+        distanceFields = false;
+        args.erase(flag);
+    }
+    
+    if (args.size() != 2) {
+        std::cerr << "Usage: snake-level-compiler [--no-distance-fields] <layout.txt> <level.snl>\n";
+        return 1;
+    }
+    
+    std::ifstream input(args[0]);
+    if (!input) {
+        std::cerr << "Could not open layout file: " << args[0] << "\n";
+        return 1;
+    }
+    
+    Layout layout;
+    if (!parseLayout(input, layout) || !writeLevel(layout, distanceFields, args[1])) {
+        return 1;
+    }
+    
+    std::cout << "Compiled " << layout.width << "x" << layout.height << " level with "
+              << layout.portals.size() / 2 << " portal pair(s) to " << args[1] << "\n";
+    return 0;
+}
@@ -0,0 +1,229 @@
+// Benchmarks ReachabilityAnalyzer against a naive flood fill per candidate move
+// and checks that both agree. A bot steers with the analyzer's answers so the
+// snake grows long enough to carve the board into pockets.
+// Usage: snake-reachability-bench [width] [height] [ticks] [seed]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "../game/ReachabilityAnalyzer.h"
+#include "../game/SnakeGame.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const Direction MOVES[4] = { Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT };
+
+struct MoveAnswer {
+    int area = 0;
+    bool tailReachable = false;
+    
+    bool operator==(const MoveAnswer& other) const {
+        return area == other.area && tailReachable == other.tailReachable;
+    }
+};
+
+// What every move query costs without the analyzer: mark the board after the
+// move and flood fill it from the new head
+class NaiveFlood {
+public:
+    NaiveFlood(int width, int height)
+        : width(width)
+        , height(height)
+        , blocked(static_cast<size_t>(width) * height)
+        , visited(static_cast<size_t>(width) * height)
+    {
+    }
+    
+    MoveAnswer query(const SnakeGame& game, Direction move) {
+        MoveAnswer answer;
+        const SnakeBody& body = game.getSnakeBody();
+        Position head = body.front();
+        switch (move) {
+            case Direction::UP:    head.y--; break;
+            case Direction::DOWN:  head.y++; break;
+            case Direction::LEFT:  head.x--; break;
+            case Direction::RIGHT: head.x++; break;
+        }
+        if (game.isGameOver() || !inside(head)) {
+            return answer;
+        }
+        
+        std::fill(blocked.begin(), blocked.end(), 0);
+        std::fill(visited.begin(), visited.end(), 0);
+        for (const Position& segment : body) {
+            blocked[cellOf(segment)] = 1;
+        }
+        if (blocked[cellOf(head)]) {
+            return answer;
+        }
+        
+        bool eating = head == game.getFoodPosition();
+        if (!eating) {
+            blocked[cellOf(body.back())] = 0;
+        }
+        blocked[cellOf(head)] = 1;
+        
+        queue.clear();
+        queue.push_back(cellOf(head));
+        visited[cellOf(head)] = 1;
+        for (size_t next = 0; next < queue.size(); ++next) {
+            int cell = queue[next];
+            int x = cell % width;
+            int y = cell / width;
+            if (x > 0) visit(cell - 1);
+            if (x < width - 1) visit(cell + 1);
+            if (y > 0) visit(cell - width);
+            if (y < height - 1) visit(cell + width);
+        }
+        answer.area = static_cast<int>(queue.size()) - 1;
+        
+        Position tail = eating ? body.back() : body[body.size() - 2];
+        const Position around[4] = { Position(tail.x - 1, tail.y), Position(tail.x + 1, tail.y),
+                                     Position(tail.x, tail.y - 1), Position(tail.x, tail.y + 1) };
+        for (const Position& pos : around) {
+            if (inside(pos) && !blocked[cellOf(pos)] && visited[cellOf(pos)]) {
+                answer.tailReachable = true;
+            }
+        }
+        return answer;
+    }
+    
+private:
+    int width;
+    int height;
+    std::vector<std::uint8_t> blocked;
+    std::vector<std::uint8_t> visited;
+    std::vector<int> queue;
+    
+    bool inside(const Position& pos) const {
+        return pos.x >= 0 && pos.x < width && pos.y >= 0 && pos.y < height;
+    }
+    int cellOf(const Position& pos) const { return pos.y * width + pos.x; }
+    
+    void visit(int cell) {
+        if (!blocked[cell] && !visited[cell]) {
+            visited[cell] = 1;
+            queue.push_back(cell);
+        }
+    }
+};
+
+// Head for the food while the tail stays reachable, otherwise take the most room
+Direction chooseMove(const SnakeGame& game, const MoveAnswer (&answers)[4]) {
+    const Position& head = game.getSnakeBody().front();
+    const Position& food = game.getFoodPosition();
+    int best = -1;
+    long bestScore = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (answers[i].area == 0 && !answers[i].tailReachable) {
+            continue;
+        }
+        Position next = head;
+        switch (MOVES[i]) {
+            case Direction::UP:    next.y--; break;
+            case Direction::DOWN:  next.y++; break;
+            case Direction::LEFT:  next.x--; break;
+            case Direction::RIGHT: next.x++; break;
+        }
+        long distance = std::abs(next.x - food.x) + std::abs(next.y - food.y);
+        long score = answers[i].tailReachable ? (1L << 40) - distance : answers[i].area;
+        if (best < 0 || score > bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+    return best < 0 ? game.getCurrentDirection() : MOVES[best];
+}
+
+double micros(Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int width = argc > 1 ? std::atoi(argv[1]) : 128;
+    int height = argc > 2 ? std::atoi(argv[2]) : 128;
+    long ticks = argc > 3 ? std::atol(argv[3]) : 20000;
+    unsigned seed = argc > 4 ? static_cast<unsigned>(std::atol(argv[4])) : 1;
+    
+    if (width < 4 || height < 2 || ticks <= 0) {
+        std::cerr << "Usage: snake-reachability-bench [width] [height] [ticks] [seed]\n";
+        return 1;
+    }
+    
+    SnakeGame game(width, height);
+    game.setSeed(seed);
+    game.reset();
+    
+    ReachabilityAnalyzer analyzer;
+    if (!analyzer.attach(game)) {
+        return 1;
+    }
+    NaiveFlood naive(width, height);
+    
+    Clock::duration syncTime{};
+    Clock::duration incrementalTime{};
+    Clock::duration naiveTime{};
+    long mismatches = 0;
+    long games = 1;
+    size_t longest = 0;
+    
+    for (long tick = 0; tick < ticks; ++tick) {
+        MoveAnswer incremental[4];
+        MoveAnswer flood[4];
+        
+        auto start = Clock::now();
+        for (int i = 0; i < 4; ++i) {
+            incremental[i].area = analyzer.reachableArea(MOVES[i]);
+            incremental[i].tailReachable = analyzer.canReachTail(MOVES[i]);
+        }
+        auto middle = Clock::now();
+        for (int i = 0; i < 4; ++i) {
+            flood[i] = naive.query(game, MOVES[i]);
+        }
+        auto end = Clock::now();
+        incrementalTime += middle - start;
+        naiveTime += end - middle;
+        
+        for (int i = 0; i < 4; ++i) {
+            if (!(incremental[i] == flood[i])) {
+                mismatches++;
+            }
+        }
+        
+        game.setDirection(chooseMove(game, flood));
+        game.update();
+        longest = std::max(longest, game.getSnakeBody().size());
+        if (game.isGameOver()) {
+            game.reset();
+            games++;
+        }
+        
+        start = Clock::now();
+        analyzer.sync();
+        syncTime += Clock::now() - start;
+    }
+    
+    const ReachabilityAnalyzer::Stats& stats = analyzer.getStats();
+    double queries = static_cast<double>(ticks) * 4;
+    double incrementalPerMove = micros(incrementalTime) / queries;
+    double naivePerMove = micros(naiveTime) / queries;
+    
+    std::cout << "Board: " << width << "x" << height << ", " << ticks << " ticks over " << games
+              << " game(s), longest snake " << longest << "\n";
+    std::cout << "Incremental: " << micros(syncTime) / ticks << " us sync per tick, "
+              << incrementalPerMove << " us per move query\n";
+    std::cout << "Flood fill:  " << naivePerMove << " us per move query ("
+              << (incrementalPerMove > 0 ? naivePerMove / incrementalPerMove : 0) << "x slower)\n";
+    std::cout << "Analyzer: " << stats.rebuilds << " rebuild(s), " << stats.splitSearches
+              << " split search(es) over " << stats.searchedCells << " cell(s)\n";
+    std::cout << "Mismatches: " << mismatches << "\n";
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,265 @@
+// Plays bot games through CLIRenderer into an emulated terminal and checks
+// that no frame scrolls the screen and that every incremental frame leaves
+// the same screen as a full repaint of that tick.
+// Usage: snake-render-check [ticks] [seed]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../cli/CLIRenderer.h"
+#include "../game/SnakeGame.h"
+
+namespace {
+
+const Direction MOVES[4] = { Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT };
+
+// Just enough of a VT100 for what CLIRenderer writes: cursor moves, erase,
+// colors and UTF-8 glyphs. Line feeds and autowrap past the last line scroll.
+class Terminal {
+public:
+    Terminal(int cols, int rows)
+        : cols(cols)
+        , rows(rows)
+        , cells(static_cast<size_t>(cols) * rows)
+    {
+    }
+    
+    int getScrolls() const { return scrolls; }
+    
+    bool operator==(const Terminal& other) const {
+        return cells == other.cells;
+    }
+    
+    void feed(const std::string& bytes) {
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            unsigned char byte = static_cast<unsigned char>(bytes[i]);
+            if (byte == 27 && i + 1 < bytes.size() && bytes[i + 1] == '[') {
+                size_t end = i + 2;
+                while (end < bytes.size() && (bytes[end] < 0x40 || bytes[end] > 0x7E)) {
+                    end++;
+                }
+                if (end < bytes.size()) {
+                    control(bytes.substr(i + 2, end - i - 2), bytes[end]);
+                }
+                i = end;
+            } else if (byte == '\n') {
+                // The tty turns \n into \r\n
+                column = 0;
+                wrapPending = false;
+                lineFeed();
+            } else if (byte == '\r') {
+                column = 0;
+                wrapPending = false;
+            } else if ((byte & 0xC0) == 0x80) {
+                cells[lastCell] += static_cast<char>(byte);
+            } else {
+                put(static_cast<char>(byte));
+            }
+        }
+    }
+
+private:
+    void put(char glyph) {
+        if (wrapPending) {
+            column = 0;
+            wrapPending = false;
+            lineFeed();
+        }
+        lastCell = static_cast<size_t>(row) * cols + column;
+        cells[lastCell] = attributes + glyph;
+        if (column == cols - 1) {
+            wrapPending = true;
+        } else {
+            column++;
+        }
+    }
+    
+    void lineFeed() {
+        if (row < rows - 1) {
+            row++;
+            return;
+        }
+        scrolls++;
+        std::rotate(cells.begin(), cells.begin() + cols, cells.end());
+        std::fill(cells.end() - cols, cells.end(), std::string());
+    }
+    
+    void control(const std::string& params, char command) {
+        switch (command) {
+            case 'H': {
+                int line = 1;
+                int col = 1;
+                char separator;
+                std::istringstream in(params);
+                in >> line >> separator >> col;
+                row = std::max(0, std::min(line, rows) - 1);
+                column = std::max(0, std::min(col, cols) - 1);
+                wrapPending = false;
+                break;
+            }
+            case 'K':
+                std::fill(cells.begin() + static_cast<size_t>(row) * cols + column,
+                          cells.begin() + static_cast<size_t>(row + 1) * cols, std::string());
+                break;
+            case 'J':
+                std::fill(cells.begin(), cells.end(), std::string());
+                break;
+            case 'm':
+                attributes = (params.empty() || params == "0") ? std::string() : params;
+                break;
+            default:
+                break;
+        }
+    }
+    
+    int cols;
+    int rows;
+    std::vector<std::string> cells;
+    std::string attributes;
+    int row = 0;
+    int column = 0;
+    bool wrapPending = false;
+    size_t lastCell = 0;
+    int scrolls = 0;
+};
+
+// Turns now and then, avoiding walls and the body where it can
+Direction chooseMove(const SnakeGame& game, std::mt19937& rng) {
+    const SnakeBody& body = game.getSnakeBody();
+    std::vector<Direction> safe;
+    for (Direction move : MOVES) {
+        Position next = body.front();
+        switch (move) {
+            case Direction::UP:    next.y--; break;
+            case Direction::DOWN:  next.y++; break;
+            case Direction::LEFT:  next.x--; break;
+            case Direction::RIGHT: next.x++; break;
+        }
+        if (next.x >= 0 && next.y >= 0 && next.x < game.getBoardWidth() && next.y < game.getBoardHeight() &&
+            std::find(body.begin(), body.end() - 1, next) == body.end() - 1) {
+            safe.push_back(move);
+        }
+    }
+    
+    Direction current = game.getCurrentDirection();
+    bool keep = std::find(safe.begin(), safe.end(), current) != safe.end() && rng() % 8 != 0;
+    if (keep || safe.empty()) {
+        return current;
+    }
+    return safe[rng() % safe.size()];
+}
+
+struct Scenario {
+    const char* name;
+    GameMode mode;
+    int boardWidth;     // 0 for the mode's default board
+    int boardHeight;
+    int cols;
+    int rows;
+    bool halfBlock;
+    const char* status;
+};
+
+// Captures what a renderer writes to std::cout
+template <typename Draw>
+std::string capture(Draw draw) {
+    std::ostringstream frame;
+    std::streambuf* previous = std::cout.rdbuf(frame.rdbuf());
+    draw();
+    std::cout.rdbuf(previous);
+    return frame.str();
+}
+
+int runScenario(const Scenario& scenario, int ticks, std::uint32_t seed) {
+    SnakeGame game = scenario.boardWidth > 0 ? SnakeGame(scenario.boardWidth, scenario.boardHeight)
+                                             : SnakeGame(scenario.mode);
+    game.setSeed(seed);
+    game.reset();
+    std::mt19937 rng(seed);
+    
+    // One renderer draws incrementally, the other repaints every tick
+    std::unique_ptr<CLIRenderer> incremental;
+    std::unique_ptr<CLIRenderer> full;
+    capture([&] {
+        incremental.reset(new CLIRenderer());
+        full.reset(new CLIRenderer());
+    });
+    capture([&] {
+        for (CLIRenderer* renderer : { incremental.get(), full.get() }) {
+            renderer->setTerminalSize(scenario.cols, scenario.rows);
+            renderer->setHalfBlockMode(scenario.halfBlock);
+            if (scenario.status) {
+                renderer->setStatusText(scenario.status);
+            }
+        }
+    });
+    
+    Terminal screen(scenario.cols, scenario.rows);
+    int mismatches = 0;
+    int scrolls = 0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        int scrolledBefore = screen.getScrolls();
+        screen.feed(capture([&] { incremental->render(game); }));
+        
+        Terminal reference(scenario.cols, scenario.rows);
+        full->requestRepaint();
+        reference.feed(capture([&] { full->render(game); }));
+        
+        if (screen.getScrolls() != scrolledBefore || reference.getScrolls() != 0) {
+            scrolls++;
+        }
+        if (!(screen == reference)) {
+            mismatches++;
+        }
+        
+        game.setDirection(chooseMove(game, rng));
+        game.update();
+        if (game.isGameOver()) {
+            game.reset();
+        }
+    }
+    
+    capture([&] {
+        incremental.reset();
+        full.reset();
+    });
+    
+    std::cout << scenario.name << ": " << ticks << " ticks on " << scenario.cols << "x" << scenario.rows
+              << ", " << scrolls << " scrolled frame(s), " << mismatches << " mismatch(es)\n";
+    return scrolls + mismatches;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 2000;
+    std::uint32_t seed = argc > 2 ? static_cast<std::uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1;
+    if (ticks <= 0) {
+        std::cerr << "Usage: snake-render-check [ticks] [seed]\n";
+        return 1;
+    }
+    
+    const char* replayStatus = "Replay 105/340 x1 paused | Space pause | Left/Right seek | Up/Down speed | 0-9 jump | Q quit";
+    const Scenario scenarios[] = {
+        { "classic",            GameMode::CLASSIC, 0,   0,  80, 24, false, nullptr },
+        { "classic half-block", GameMode::CLASSIC, 0,   0,  80, 24, true,  nullptr },
+        { "classic small",      GameMode::CLASSIC, 0,   0,  30, 12, false, nullptr },
+        { "large board",        GameMode::CLASSIC, 120, 60, 80, 24, false, replayStatus },
+        { "large half-block",   GameMode::CLASSIC, 120, 60, 80, 24, true,  replayStatus },
+        { "endless",            GameMode::ENDLESS, 0,   0,  80, 24, false, nullptr },
+        { "endless half-block", GameMode::ENDLESS, 0,   0,  100, 30, true, replayStatus },
+    };
+    
+    int failures = 0;
+    for (const Scenario& scenario : scenarios) {
+        failures += runScenario(scenario, ticks, seed);
+    }
+    return failures == 0 ? 0 : 1;
+}